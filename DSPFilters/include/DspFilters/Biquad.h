@@ -126,6 +126,34 @@ public:
 
 //------------------------------------------------------------------------------
 
+// Normalized (a0 == 1) coefficients of a biquad stored in a chosen precision.
+// Member names match BiquadBase so the state classes accept either one.
+template <typename Real>
+struct BiquadCoefficients
+{
+  BiquadCoefficients ()
+    : m_a1 (0), m_a2 (0), m_b1 (0), m_b2 (0), m_b0 (1)
+  {
+  }
+
+  explicit BiquadCoefficients (const BiquadBase& s)
+    : m_a1 (static_cast<Real> (s.m_a1))
+    , m_a2 (static_cast<Real> (s.m_a2))
+    , m_b1 (static_cast<Real> (s.m_b1))
+    , m_b2 (static_cast<Real> (s.m_b2))
+    , m_b0 (static_cast<Real> (s.m_b0))
+  {
+  }
+
+  Real m_a1;
+  Real m_a2;
+  Real m_b1;
+  Real m_b2;
+  Real m_b0;
+};
+
+//------------------------------------------------------------------------------
+
 // Expresses a biquad as a pair of pole/zeros, with gain
 // values so that the coefficients can be reconstructed precisely.
 struct BiquadPoleState : PoleZeroPair
@@ -0,0 +1,220 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_BLOCKSTATESPACE_H
+#define DSPFILTERS_BLOCKSTATESPACE_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Biquad.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+#include "DspFilters/State.h"
+
+namespace Dsp {
+
+/*
+ * Block state-space kernel for a designed cascade.
+ *
+ * A cascade is linear in its input and state, so a block of BlockSize
+ * outputs and the state after the block are one matrix times the block
+ * of inputs and the state before it:
+ *
+ *   [ y[0..N-1] ]   [ T  O ] [ u[0..N-1] ]
+ *   [ s'        ] = [ G  F ] [ s         ]
+ *
+ * T is the lower triangular Toeplitz matrix of the impulse response, O
+ * maps the state to the outputs, F is the N-step state transition and G
+ * feeds the inputs into the next state. The matrix is precomputed by
+ * running the cascade itself over unit inputs and unit states, so it
+ * agrees with the recursive form to rounding.
+ *
+ * Evaluating it is a dense matrix-vector product: no output waits on
+ * another, and the inner loops run down contiguous columns, which the
+ * compiler turns into SIMD multiply-adds. This removes the sample to
+ * sample recursion that bounds the recursive forms, at the cost of about
+ * N/2 + 2K + K*K/N multiply-adds per sample for a filter of order K.
+ *
+ * The state is the flattened Transposed Direct Form II state of the
+ * cascade (Cascade::StateBase::getState with TransposedDirectFormII),
+ * so a stream can move between this kernel and a recursive one. Samples
+ * that do not fill a whole block are filtered recursively.
+ *
+ */
+
+template <int MaxStages, int BlockSize = 16>
+class BlockStateSpace
+{
+public:
+  enum
+  {
+    MaxOrder = 2 * MaxStages,
+    ColumnSize = BlockSize + MaxOrder // rows of the matrix, and its maximum columns
+  };
+
+  BlockStateSpace ()
+    : m_numStages (0)
+    , m_order (0)
+  {
+  }
+
+  explicit BlockStateSpace (const Cascade& cascade)
+  {
+    setup (cascade);
+  }
+
+  // Build the block matrix of a designed cascade with at
+  // most MaxStages stages.
+  void setup (const Cascade& cascade)
+  {
+    m_numStages = cascade.getNumStages ();
+    assert (m_numStages <= MaxStages);
+    m_order = 2 * m_numStages;
+    for (int i = 0; i < m_numStages; ++i)
+      m_coeffs[i] = BiquadCoefficients <double> (cascade[i]);
+
+    // column c: inputs first (unit impulse at sample c), then states
+    // (unit value in state element c - BlockSize)
+    const int rows = BlockSize + m_order;
+    for (int c = 0; c < rows; ++c)
+    {
+      double s[MaxOrder];
+      for (int k = 0; k < m_order; ++k)
+        s[k] = (c - BlockSize == k) ? 1 : 0;
+
+      double* column = m_matrix + c * ColumnSize;
+      for (int n = 0; n < BlockSize; ++n)
+        column[n] = (n == c) ? 1 : 0;
+      filterRecursive (BlockSize, column, 1, s);
+      for (int k = 0; k < m_order; ++k)
+        column[BlockSize + k] = s[k];
+    }
+  }
+
+  int getNumStages () const
+  {
+    return m_numStages;
+  }
+
+  // Process a block of samples. 'state' holds 2 * getNumStages () values
+  // and is updated in place. 'stride' is the distance between samples, so
+  // a record can be filtered backwards with dest at its last sample and
+  // stride -1.
+  template <typename Sample>
+  void process (int numSamples, Sample* dest, double* state, int stride = 1) const
+  {
+    const int rows = BlockSize + m_order;
+    double vsa = anti_denormal_vsa;
+
+    alignas (32) double w[ColumnSize];
+    alignas (32) double z[ColumnSize];
+    for (; numSamples >= BlockSize; numSamples -= BlockSize)
+    {
+      for (int n = 0; n < BlockSize; ++n)
+        w[n] = dest[n * stride];
+      for (int k = 0; k < m_order; ++k)
+        w[BlockSize + k] = state[k];
+      // one anti-denormal impulse per block, alternating in sign
+      w[0] += (vsa = -vsa);
+
+      // z = M w, four columns at a time. Input column n only reaches
+      // outputs n and later, the rows above are zero and skipped. State
+      // columns reach every row.
+      for (int r = 0; r < rows; ++r)
+        z[r] = 0;
+      int c = 0;
+      for (; c + 3 < rows; c += 4)
+      {
+        const double* m0 = m_matrix + c * ColumnSize;
+        const double* m1 = m0 + ColumnSize;
+        const double* m2 = m1 + ColumnSize;
+        const double* m3 = m2 + ColumnSize;
+        const double w0 = w[c], w1 = w[c + 1], w2 = w[c + 2], w3 = w[c + 3];
+        for (int r = (c + 3 < BlockSize) ? c : 0; r < rows; ++r)
+          z[r] += m0[r]*w0 + m1[r]*w1 + m2[r]*w2 + m3[r]*w3;
+      }
+      for (; c < rows; ++c)
+      {
+        const double* m0 = m_matrix + c * ColumnSize;
+        const double w0 = w[c];
+        for (int r = (c < BlockSize) ? c : 0; r < rows; ++r)
+          z[r] += m0[r]*w0;
+      }
+
+      for (int n = 0; n < BlockSize; ++n)
+        dest[n * stride] = static_cast<Sample> (z[n]);
+      for (int k = 0; k < m_order; ++k)
+        state[k] = z[BlockSize + k];
+      if (numSamples > BlockSize)
+        dest += BlockSize * stride;
+    }
+
+    if (numSamples > 0)
+    {
+      for (int n = 0; n < numSamples; ++n)
+        w[n] = dest[n * stride];
+      filterRecursive (numSamples, w, 1, state);
+      for (int n = 0; n < numSamples; ++n)
+        dest[n * stride] = static_cast<Sample> (w[n]);
+    }
+  }
+
+private:
+  // Sample by sample through the cascade, starting from and
+  // updating the flattened state.
+  void filterRecursive (int numSamples, double* dest, int stride, double* state) const
+  {
+    BasicTransposedDirectFormII <double> stage[MaxStages];
+    for (int i = 0; i < m_numStages; ++i)
+      stage[i].setState (state + 2 * i);
+    for (int n = 0; n < numSamples; ++n, dest += stride)
+    {
+      double x = *dest;
+      for (int i = 0; i < m_numStages; ++i)
+        x = stage[i].process1 (x, m_coeffs[i], 0);
+      *dest = x;
+    }
+    for (int i = 0; i < m_numStages; ++i)
+      stage[i].getState (state + 2 * i);
+  }
+
+  BiquadCoefficients <double> m_coeffs[MaxStages];
+  int m_numStages;
+  int m_order;
+  alignas (32) double m_matrix[ColumnSize * ColumnSize];
+};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_CASCADECHAIN_H
+#define DSPFILTERS_CASCADECHAIN_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Biquad.h"
+#include "DspFilters/Cascade.h"
+
+namespace Dsp {
+
+/*
+ * A Cascade assembled from the stages of several designs.
+ *
+ * Running a band-pass, a notch and a differentiator as separate filters
+ * costs one pass over the data and one state array each. Since every
+ * one of them is a list of biquads, the lists can be appended into a
+ * single cascade instead: one state, one loop, and the same transfer
+ * function as the filters in series.
+ *
+ * Intermediate signals, for example the band-passed signal before the
+ * differentiator, come from the tapped processing functions of the
+ * state (Cascade::StateBase::processTapped and processBlockTapped),
+ * which store the output of chosen stages during the same pass.
+ *
+ *   Dsp::CascadeChain <8> chain;
+ *   chain.append (bandPass);        // any designed Cascade
+ *   chain.append (mainsNotch);      // any single biquad, e.g. RBJ
+ *   chain.appendDifferentiator (fs);
+ *   Dsp::CascadeChain <8>::State <Dsp::DirectFormII> state;
+ *   state.processBlockTapped (n, samples, chain, 1u << 2, &notched);
+ *
+ * Appending changes the stages in place; reset any state that was
+ * running on the chain.
+ *
+ */
+template <int MaxStages>
+class CascadeChain : public Cascade
+                   , public CascadeStages <MaxStages>
+{
+public:
+  CascadeChain ()
+    : m_numLinks (0)
+  {
+    setCascadeStorage (this->getCascadeStorage ());
+  }
+
+  // Remove all stages
+  void clear ()
+  {
+    m_numLinks = 0;
+    setCascadeStorage (this->getCascadeStorage ());
+  }
+
+  // Append every stage of a designed cascade
+  void append (const Cascade& cascade)
+  {
+    for (int i = 0; i < cascade.getNumStages (); ++i)
+      appendLink (cascade[i]);
+    commit ();
+  }
+
+  // Append a single biquad (RBJ designs are BiquadBase)
+  void append (const BiquadBase& biquad)
+  {
+    appendLink (biquad);
+    commit ();
+  }
+
+  // Append the central difference y[n] = (x[n] - x[n-2]) * sampleRate / 2,
+  // the derivative in units per second delayed by one sample. Unlike the
+  // first difference it has a zero at Nyquist, so it does not amplify
+  // the highest frequencies.
+  void appendDifferentiator (double sampleRate)
+  {
+    Biquad d;
+    d.setTwoPole (0, 1, 0, -1);
+    d.applyScale (sampleRate / 2);
+    appendLink (d);
+    commit ();
+  }
+
+private:
+  void appendLink (const BiquadBase& biquad)
+  {
+    assert (m_numLinks < MaxStages);
+    static_cast<BiquadBase&> (m_links[m_numLinks++]) = biquad;
+  }
+
+  void commit ()
+  {
+    setStages (m_links, m_numLinks);
+  }
+
+  int m_numLinks;
+  Biquad m_links[MaxStages];
+};
+
+}
+
+#endif
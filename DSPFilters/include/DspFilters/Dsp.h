@@ -43,8 +43,13 @@ THE SOFTWARE.
 #include "DspFilters/Common.h"
 
 #include "DspFilters/Biquad.h"
+#include "DspFilters/BlockStateSpace.h"
 #include "DspFilters/Cascade.h"
+#include "DspFilters/CascadeChain.h"
 #include "DspFilters/Filter.h"
+#include "DspFilters/FixedCascade.h"
+#include "DspFilters/FixedPoint.h"
+#include "DspFilters/ParallelForm.h"
 #include "DspFilters/PoleFilter.h"
 #include "DspFilters/SmoothedFilter.h"
 #include "DspFilters/State.h"
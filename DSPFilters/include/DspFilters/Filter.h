@@ -253,6 +253,14 @@ public:
     m_state.reset();
   }
 
+  // Put every channel in the steady state for the constant input 'in'
+  // (see Cascade::StateBase::setSteadyState).
+  void setSteadyState (const double in)
+  {
+    for (int i = 0; i < Channels; ++i)
+      m_state[i].setSteadyState (in, *((FilterClass*)this));
+  }
+
   template <typename Sample>
   void process (int numSamples, Sample* const* arrayOfChannels)
   {
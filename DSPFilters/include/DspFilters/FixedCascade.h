@@ -0,0 +1,100 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_FIXEDCASCADE_H
+#define DSPFILTERS_FIXEDCASCADE_H
+
+#include "DspFilters/Common.h"
+
+namespace Dsp {
+
+/*
+ * Cascade sections with the number of stages fixed at compile time.
+ *
+ * The coefficients of a designed Cascade are read from one flat array
+ * (b0 b1 b2 a1 a2 per stage) and the stages are unrolled through
+ * template recursion, so processing a sample involves no loop counter
+ * and no pointer chasing. The state is Direct Form II, v[-1] v[-2] per
+ * stage: the same layout as Cascade::StateBase::getState, so a stream
+ * can move between these sections and a Cascade. The results are
+ * identical to Cascade with DirectFormII state.
+ *
+ * The caller owns both arrays. A kernel whose stage count is only known
+ * at run time instantiates one chain per count and picks one in setup:
+ *
+ *   double c[5 * 3]; // b0 b1 b2 a1 a2, copied from design[i]
+ *   double v[2 * 3] = { 0 };
+ *   out = Dsp::FixedCascadeSections <0, 3, double>::process (in, c, v, 0);
+ *
+ * vsa is added at the input of the first stage only.
+ *
+ */
+
+// Unrolled Direct Form II section chain, stage by stage
+template <int Stage, int Stages, typename Real>
+struct FixedCascadeSections
+{
+  static inline Real process (const Real in,
+                              const Real* c,
+                              Real* v,
+                              const Real vsa)
+  {
+    const Real* k = c + 5 * Stage;
+    Real* s = v + 2 * Stage;
+
+    const Real w   = in - k[3]*s[0] - k[4]*s[1] + vsa;
+    const Real out =      k[0]*w    + k[1]*s[0] + k[2]*s[1];
+    s[1] = s[0];
+    s[0] = w;
+
+    return FixedCascadeSections <Stage + 1, Stages, Real>::process (out, c, v, 0);
+  }
+};
+
+template <int Stages, typename Real>
+struct FixedCascadeSections <Stages, Stages, Real>
+{
+  static inline Real process (const Real in,
+                              const Real*,
+                              Real*,
+                              const Real)
+  {
+    return in;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,357 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_FIXEDPOINT_H
+#define DSPFILTERS_FIXEDPOINT_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Biquad.h"
+#include "DspFilters/Cascade.h"
+
+#include <stdint.h>
+
+namespace Dsp {
+
+/*
+ * Fixed point second order sections for integer pipelines.
+ *
+ * This is the arithmetic of a typical MCU biquad (the same layout as
+ * CMSIS-DSP's arm_biquad_cascade_df1_q31 with postShift = 1), written
+ * with integer operations only so the host build produces bit-exact
+ * results of the firmware:
+ *
+ *  - Coefficients are Q31 values with a post shift of one bit, i.e.
+ *    Q2.30, so that |a1| < 2 is representable.
+ *
+ *  - Signals are int32 with FixedPointSignalShift fractional bits below
+ *    the sample LSB. A 16-bit (Q15) sample keeps 8 bits of headroom.
+ *
+ *  - Each section is Direct Form I with a 64-bit accumulator. The bits
+ *    discarded when the accumulator is reduced to the output width are
+ *    fed back into the next accumulation (first order error feedback),
+ *    which removes the large quantization noise gain of poles near z=1.
+ *
+ *  - Five products of up to 2^62 each do not fit one int64 when the
+ *    states are saturated, so the accumulator is kept as two parts split
+ *    at the output binary point. Wherever the single 64-bit sum of the
+ *    firmware would not wrap the result is identical; where it would,
+ *    the output saturates instead.
+ *
+ * FixedPointDirectFormI may be used as the StateType of any Cascade.
+ * It then quantizes the double coefficients on every call and converts
+ * the double samples at the cascade boundary. The result is bit for bit
+ * the value computed by FixedPointCascade, which quantizes once in
+ * setup and runs without floating point.
+ *
+ * Right shifts of negative values are assumed to be arithmetic, as on
+ * every supported compiler and MCU.
+ *
+ */
+
+enum
+{
+  FixedPointCoefficientBits = 30, // Q31 with a post shift of 1
+  FixedPointSignalShift = 8,      // fractional bits below the sample LSB
+  FixedPointResidualMask = (1 << FixedPointCoefficientBits) - 1
+};
+
+struct FixedPointCoefficients
+{
+  FixedPointCoefficients ()
+    : m_a1 (0)
+    , m_a2 (0)
+    , m_b1 (0)
+    , m_b2 (0)
+    , m_b0 (int32_t (1) << FixedPointCoefficientBits)
+  {
+  }
+
+  explicit FixedPointCoefficients (const BiquadBase& s)
+    : m_a1 (quantize (s.m_a1))
+    , m_a2 (quantize (s.m_a2))
+    , m_b1 (quantize (s.m_b1))
+    , m_b2 (quantize (s.m_b2))
+    , m_b0 (quantize (s.m_b0))
+  {
+  }
+
+  // Round to nearest, saturating to the int32 range
+  static int32_t quantize (double c)
+  {
+    const double v = std::floor (c * (int64_t (1) << FixedPointCoefficientBits) + 0.5);
+    if (v >= 2147483647.)
+      return 2147483647;
+    if (v <= -2147483648.)
+      return -2147483647 - 1;
+    return static_cast<int32_t> (v);
+  }
+
+  int32_t m_a1;
+  int32_t m_a2;
+  int32_t m_b1;
+  int32_t m_b2;
+  int32_t m_b0;
+};
+
+class FixedPointDirectFormI
+{
+public:
+  FixedPointDirectFormI ()
+  {
+    reset ();
+  }
+
+  void reset ()
+  {
+    m_x1 = 0;
+    m_x2 = 0;
+    m_y1 = 0;
+    m_y2 = 0;
+    m_error = 0;
+  }
+
+  // Integer kernel. in and the result are in the internal signal format.
+  inline int32_t processFixed (const int32_t in, const FixedPointCoefficients& s)
+  {
+    // acc = high * 2^30 + low. Each product adds at most 2^32 to high and
+    // less than 2^30 to low, so neither part can overflow.
+    int64_t high = 0;
+    int64_t low = m_error;
+    accumulate (high, low, int64_t (s.m_b0) * in);
+    accumulate (high, low, int64_t (s.m_b1) * m_x1);
+    accumulate (high, low, int64_t (s.m_b2) * m_x2);
+    accumulate (high, low, -int64_t (s.m_a1) * m_y1);
+    accumulate (high, low, -int64_t (s.m_a2) * m_y2);
+
+    // Saturate to the int32 range like the MCU's SSAT. A clipped sample
+    // has no meaningful residual, so the error feedback restarts at zero.
+    const int64_t y = high + (low >> FixedPointCoefficientBits);
+    int32_t out;
+    if (y > 2147483647)
+    {
+      out = 2147483647;
+      m_error = 0;
+    }
+    else if (y < -2147483647 - 1)
+    {
+      out = -2147483647 - 1;
+      m_error = 0;
+    }
+    else
+    {
+      out = static_cast<int32_t> (y);
+      m_error = low & FixedPointResidualMask;
+    }
+
+    m_x2 = m_x1;
+    m_x1 = in;
+    m_y2 = m_y1;
+    m_y1 = out;
+
+    return out;
+  }
+
+  // Steady state for a constant input in the internal signal format.
+  // Returns the constant output, rounded to the nearest integer. The
+  // integer recursion has no exact fixed point in general, so the
+  // remaining error is at most half an internal LSB.
+  int32_t setSteadyStateFixed (const int32_t in, const FixedPointCoefficients& s)
+  {
+    const int64_t den = (int64_t (1) << FixedPointCoefficientBits) + s.m_a1 + s.m_a2;
+    const int64_t sumB = int64_t (s.m_b0) + s.m_b1 + s.m_b2;
+    const int32_t out = (den != 0)
+      ? static_cast<int32_t> (std::floor (double (in) * sumB / den + 0.5)) : 0;
+    m_x1 = m_x2 = in;
+    m_y1 = m_y2 = out;
+    m_error = 0;
+    return out;
+  }
+
+  // Cascade interface. Samples are converted to the internal format at
+  // the boundary; the conversion is exact between sections. Fixed point
+  // has no denormals, so vsa is ignored.
+  template <typename Sample>
+  inline Sample process1 (const Sample in,
+                          const FixedPointCoefficients& s,
+                          const double /*vsa*/)
+  {
+    const int32_t x = static_cast<int32_t> (
+      std::floor (in * (1 << FixedPointSignalShift) + 0.5));
+    return static_cast<Sample> (double (processFixed (x, s)) / (1 << FixedPointSignalShift));
+  }
+
+  template <typename Sample>
+  inline Sample process1 (const Sample in,
+                          const BiquadBase& s,
+                          const double vsa)
+  {
+    return process1 (in, FixedPointCoefficients (s), vsa);
+  }
+
+  template <class Coefficients>
+  double setSteadyState (const double in, const Coefficients& s)
+  {
+    const int32_t x = static_cast<int32_t> (
+      std::floor (in * (1 << FixedPointSignalShift) + 0.5));
+    return double (setSteadyStateFixed (x, FixedPointCoefficients (s))) /
+      (1 << FixedPointSignalShift);
+  }
+
+private:
+  static inline void accumulate (int64_t& high, int64_t& low, const int64_t product)
+  {
+    high += product >> FixedPointCoefficientBits;
+    low += product & FixedPointResidualMask;
+  }
+
+  int32_t m_x1; // x[n-1]
+  int32_t m_x2; // x[n-2]
+  int32_t m_y1; // y[n-1]
+  int32_t m_y2; // y[n-2]
+  int64_t m_error; // bits dropped from the last accumulator
+};
+
+//------------------------------------------------------------------------------
+
+/*
+ * A cascade of fixed point sections with coefficients quantized once,
+ * processing 16-bit samples with integer arithmetic only. This is the
+ * host emulation of the firmware filter.
+ *
+ *   Dsp::FixedPointCascade <4> q;
+ *   q.setup (design);
+ *   Dsp::FixedPointCascade <4>::State state;
+ *   q.process (numSamples, int16Samples, state);
+ *
+ */
+template <int MaxStages>
+class FixedPointCascade
+{
+public:
+  class State
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < MaxStages; ++i)
+        m_states[i].reset ();
+    }
+
+    // One sample in the internal signal format
+    inline int32_t processFixed (int32_t in, const FixedPointCascade& c)
+    {
+      FixedPointDirectFormI* state = m_states;
+      const FixedPointCoefficients* stage = c.m_stages;
+      for (int i = c.m_numStages; --i >= 0; ++state, ++stage)
+        in = state->processFixed (in, *stage);
+      return in;
+    }
+
+    // One Q15 sample, rounded and saturated back to 16 bits
+    inline int16_t process (const int16_t in, const FixedPointCascade& c)
+    {
+      const int32_t half = int32_t (1) << (FixedPointSignalShift - 1);
+      const int64_t y = int64_t (processFixed (int32_t (in) << FixedPointSignalShift, c));
+      int32_t out = static_cast<int32_t> ((y + half) >> FixedPointSignalShift);
+      if (out > 32767)
+        out = 32767;
+      else if (out < -32768)
+        out = -32768;
+      return static_cast<int16_t> (out);
+    }
+
+    // Steady state for a constant Q15 input, in O(stages)
+    void setSteadyState (const int16_t in, const FixedPointCascade& c)
+    {
+      int32_t x = int32_t (in) << FixedPointSignalShift;
+      for (int i = 0; i < c.m_numStages; ++i)
+        x = m_states[i].setSteadyStateFixed (x, c.m_stages[i]);
+    }
+
+  private:
+    FixedPointDirectFormI m_states[MaxStages];
+  };
+
+  FixedPointCascade ()
+    : m_numStages (0)
+  {
+  }
+
+  explicit FixedPointCascade (const Cascade& cascade)
+  {
+    setup (cascade);
+  }
+
+  void setup (const Cascade& cascade)
+  {
+    m_numStages = cascade.getNumStages ();
+    assert (m_numStages <= MaxStages);
+    for (int i = 0; i < m_numStages; ++i)
+      m_stages[i] = FixedPointCoefficients (cascade[i]);
+  }
+
+  int getNumStages () const
+  {
+    return m_numStages;
+  }
+
+  const FixedPointCoefficients& operator[] (int index) const
+  {
+    assert (index >= 0 && index < m_numStages);
+    return m_stages[index];
+  }
+
+  // Process a block of Q15 samples in place
+  void process (int numSamples, int16_t* dest, State& state) const
+  {
+    while (--numSamples >= 0) {
+      *dest = state.process (*dest, *this);
+      dest++;
+    }
+  }
+
+private:
+  int m_numStages;
+  FixedPointCoefficients m_stages[MaxStages];
+};
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_LANEPACK_H
+#define DSPFILTERS_LANEPACK_H
+
+#include "DspFilters/Common.h"
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define DSPFILTERS_LANEPACK_SSE2
+#endif
+
+namespace Dsp {
+
+/*
+ * A pack of adjacent lanes handled by one SIMD register.
+ *
+ * Used by the lane-parallel state types to run several channels through
+ * the same arithmetic. Without SIMD support a pack is a single scalar,
+ * so the code stays portable and gives identical results everywhere.
+ *
+ */
+template <typename Real>
+struct LanePack
+{
+  typedef Real type;
+  enum { Width = 1 };
+
+  static inline type load  (const Real* p)        { return *p; }
+  static inline void store (Real* p, type v)      { *p = v; }
+  static inline type set1  (Real v)               { return v; }
+  static inline type add   (type a, type b)       { return a + b; }
+  static inline type sub   (type a, type b)       { return a - b; }
+  static inline type mul   (type a, type b)       { return a * b; }
+};
+
+#if defined(__AVX__)
+
+template <>
+struct LanePack <double>
+{
+  typedef __m256d type;
+  enum { Width = 4 };
+
+  static inline type load  (const double* p)      { return _mm256_loadu_pd (p); }
+  static inline void store (double* p, type v)    { _mm256_storeu_pd (p, v); }
+  static inline type set1  (double v)             { return _mm256_set1_pd (v); }
+  static inline type add   (type a, type b)       { return _mm256_add_pd (a, b); }
+  static inline type sub   (type a, type b)       { return _mm256_sub_pd (a, b); }
+  static inline type mul   (type a, type b)       { return _mm256_mul_pd (a, b); }
+};
+
+template <>
+struct LanePack <float>
+{
+  typedef __m256 type;
+  enum { Width = 8 };
+
+  static inline type load  (const float* p)       { return _mm256_loadu_ps (p); }
+  static inline void store (float* p, type v)     { _mm256_storeu_ps (p, v); }
+  static inline type set1  (float v)              { return _mm256_set1_ps (v); }
+  static inline type add   (type a, type b)       { return _mm256_add_ps (a, b); }
+  static inline type sub   (type a, type b)       { return _mm256_sub_ps (a, b); }
+  static inline type mul   (type a, type b)       { return _mm256_mul_ps (a, b); }
+};
+
+#elif defined(DSPFILTERS_LANEPACK_SSE2)
+
+template <>
+struct LanePack <double>
+{
+  typedef __m128d type;
+  enum { Width = 2 };
+
+  static inline type load  (const double* p)      { return _mm_loadu_pd (p); }
+  static inline void store (double* p, type v)    { _mm_storeu_pd (p, v); }
+  static inline type set1  (double v)             { return _mm_set1_pd (v); }
+  static inline type add   (type a, type b)       { return _mm_add_pd (a, b); }
+  static inline type sub   (type a, type b)       { return _mm_sub_pd (a, b); }
+  static inline type mul   (type a, type b)       { return _mm_mul_pd (a, b); }
+};
+
+template <>
+struct LanePack <float>
+{
+  typedef __m128 type;
+  enum { Width = 4 };
+
+  static inline type load  (const float* p)       { return _mm_loadu_ps (p); }
+  static inline void store (float* p, type v)     { _mm_storeu_ps (p, v); }
+  static inline type set1  (float v)              { return _mm_set1_ps (v); }
+  static inline type add   (type a, type b)       { return _mm_add_ps (a, b); }
+  static inline type sub   (type a, type b)       { return _mm_sub_ps (a, b); }
+  static inline type mul   (type a, type b)       { return _mm_mul_ps (a, b); }
+};
+
+#endif
+
+}
+
+#endif
@@ -38,6 +38,11 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  include <xmmintrin.h>
+#  define DSPFILTERS_HAVE_MXCSR
+#endif
+
 namespace Dsp {
 
 const double doublePi		=3.1415926535897932384626433832795028841971;
@@ -149,6 +154,111 @@ private:
   double m_v;
 };
 
+//------------------------------------------------------------------------------
+
+/*
+ * Denormal policies for the cascade states (Cascade::StateBase).
+ *
+ * A policy supplies ac(), the value added to the first stage for the
+ * current sample, and a Scope type that is held while a block is
+ * processed:
+ *
+ *   DenormalInjection    the small alternating value above on every
+ *                        sample (the default, portable)
+ *   DenormalFlushToZero  nothing is injected; the FTZ and DAZ flags are
+ *                        set once per block and restored afterwards
+ *   DenormalIgnore       nothing at all
+ *
+ * The injection costs an add and a sign flip per sample and is a data
+ * dependency of the first stage. Flushing costs two MXCSR accesses per
+ * block, but only covers block calls: code that calls the per-sample
+ * process() of a DenormalFlushToZero state must hold a
+ * ScopedFlushDenormals itself. On targets without MXCSR flushing does
+ * nothing, so decaying states can become denormal there.
+ *
+ */
+
+// Sets flush-to-zero and denormals-are-zero for its lifetime. Writing
+// MXCSR is much slower than reading it, so nested scopes (a per-sample
+// call inside a caller's scope) only read it.
+class ScopedFlushDenormals
+{
+public:
+#ifdef DSPFILTERS_HAVE_MXCSR
+  enum
+  {
+    FlushToZero = 0x8000,
+    DenormalsAreZero = 0x0040
+  };
+
+  ScopedFlushDenormals ()
+    : m_csr (_mm_getcsr ())
+  {
+    if ((m_csr & (FlushToZero | DenormalsAreZero)) != (FlushToZero | DenormalsAreZero))
+      _mm_setcsr (m_csr | FlushToZero | DenormalsAreZero);
+  }
+
+  ~ScopedFlushDenormals ()
+  {
+    if ((m_csr & (FlushToZero | DenormalsAreZero)) != (FlushToZero | DenormalsAreZero))
+      _mm_setcsr (m_csr);
+  }
+
+private:
+  ScopedFlushDenormals (const ScopedFlushDenormals&);
+  ScopedFlushDenormals& operator= (const ScopedFlushDenormals&);
+
+  unsigned int m_csr;
+#else
+  ScopedFlushDenormals ()
+  {
+  }
+#endif
+};
+
+struct NoDenormalScope
+{
+  NoDenormalScope ()
+  {
+  }
+};
+
+struct DenormalInjection : DenormalPrevention
+{
+  typedef NoDenormalScope Scope;
+};
+
+struct DenormalFlushToZero
+{
+  typedef ScopedFlushDenormals Scope;
+
+  static inline double ac ()
+  {
+    return 0;
+  }
+};
+
+struct DenormalIgnore
+{
+  typedef NoDenormalScope Scope;
+
+  static inline double ac ()
+  {
+    return 0;
+  }
+};
+
+// The policy for long-running real-time filters. Flushing has no
+// per-sample cost and also covers a flat input, where the first stage
+// state is so large that the injected value is lost to rounding and the
+// later stages still decay into denormals. Without MXCSR the flags
+// cannot be set, so injection is the only protection there.
+#ifdef DSPFILTERS_HAVE_MXCSR
+typedef DenormalFlushToZero DenormalRealtime;
+#else
+typedef DenormalInjection DenormalRealtime;
+#endif
+
 }
 
 #endif
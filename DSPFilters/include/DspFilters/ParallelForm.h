@@ -0,0 +1,391 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_PARALLELFORM_H
+#define DSPFILTERS_PARALLELFORM_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+#include "DspFilters/State.h"
+
+#include <stdexcept>
+
+namespace Dsp {
+
+/*
+ * Parallel form realisation of a designed cascade.
+ *
+ * The transfer function of the cascade is expanded in partial fractions
+ * over its poles,
+ *
+ *   H(z) = sum (k) (c0k + c1k z^-1) / (1 + a1k z^-1 + a2k z^-2)
+ *        + d0 + d1 z^-1 + ... (direct FIR term)
+ *
+ * Each second order section keeps the denominator of one cascade stage,
+ * so the sections are as stable as the cascade, but they all see the
+ * same input and their outputs are summed. No section waits on another,
+ * so a sample is limited by the latency of one section instead of the
+ * whole chain, and the section loop runs over flat arrays the compiler
+ * can vectorise. The FIR term has one tap unless the numerator has a
+ * higher degree than the denominator.
+ *
+ * The expansion needs distinct poles, which holds for the pole filter
+ * designs; setup() throws std::logic_error on a repeated pole. Residues
+ * of poles that lie close together are large and cancel in the sum, so
+ * narrow or low-edge band-pass designs lose some precision compared to
+ * the cascade.
+ *
+ * Typical use:
+ *
+ *   Dsp::Butterworth::BandPass <6> design;
+ *   design.setup (3, 1000, centerFrequency, widthFrequency);
+ *   Dsp::ParallelForm <6> parallel (design);
+ *   Dsp::ParallelForm <6>::State state;
+ *   parallel.process (numSamples, samples, state);
+ *
+ */
+
+template <int MaxStages>
+class ParallelForm
+{
+public:
+  enum
+  {
+    MaxSections = MaxStages,
+    MaxFirTaps = 2 * MaxStages + 1
+  };
+
+  class State : private DenormalPrevention
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < MaxSections; ++i)
+        m_s1[i] = m_s2[i] = 0;
+      for (int i = 0; i < MaxFirTaps; ++i)
+        m_x[i] = 0;
+    }
+
+    template <typename Sample>
+    inline Sample process (const Sample in, const ParallelForm& p)
+    {
+      // Transposed Direct Form II per section, all fed the same input
+      const double x = in + ac();
+      const int numSections = p.m_numSections;
+      double out = 0;
+      for (int i = 0; i < numSections; ++i)
+      {
+        const double y = p.m_c0[i]*x + m_s1[i];
+        m_s1[i] = p.m_c1[i]*x - p.m_a1[i]*y + m_s2[i];
+        m_s2[i] = -p.m_a2[i]*y;
+        out += y;
+      }
+
+      out += p.m_fir[0]*in;
+      for (int i = p.m_numFirTaps - 1; i >= 1; --i)
+      {
+        out += p.m_fir[i]*m_x[i - 1];
+        m_x[i - 1] = (i > 1) ? m_x[i - 2] : double (in);
+      }
+
+      return static_cast<Sample> (out);
+    }
+
+    // Block kernel for a section count fixed at compile time, with a
+    // single FIR tap. The states are held in locals for the block.
+    template <int Sections, typename Sample>
+    void processSections (int numSamples, Sample* dest, const ParallelForm& p)
+    {
+      double c0[Sections + 1], c1[Sections + 1], a1[Sections + 1], a2[Sections + 1];
+      double s1[Sections + 1], s2[Sections + 1];
+      for (int i = 0; i < Sections; ++i)
+      {
+        c0[i] = p.m_c0[i]; c1[i] = p.m_c1[i];
+        a1[i] = p.m_a1[i]; a2[i] = p.m_a2[i];
+        s1[i] = m_s1[i]; s2[i] = m_s2[i];
+      }
+      const double d0 = p.m_fir[0];
+
+      while (--numSamples >= 0)
+      {
+        const double in = *dest;
+        const double x = in + ac();
+        double out = d0*in;
+        for (int i = 0; i < Sections; ++i)
+        {
+          const double y = c0[i]*x + s1[i];
+          s1[i] = c1[i]*x - a1[i]*y + s2[i];
+          s2[i] = -a2[i]*y;
+          out += y;
+        }
+        *dest++ = static_cast<Sample> (out);
+      }
+
+      for (int i = 0; i < Sections; ++i)
+      {
+        m_s1[i] = s1[i];
+        m_s2[i] = s2[i];
+      }
+    }
+
+    // Steady state for a constant input, as if it had been applied
+    // forever. Returns the constant output.
+    double setSteadyState (const double in, const ParallelForm& p)
+    {
+      double out = 0;
+      for (int i = 0; i < p.m_numSections; ++i)
+      {
+        const double den = 1 + p.m_a1[i] + p.m_a2[i];
+        const double y = (den != 0) ? in * (p.m_c0[i] + p.m_c1[i]) / den : 0;
+        m_s1[i] = y - p.m_c0[i]*in;
+        m_s2[i] = -p.m_a2[i]*y;
+        out += y;
+      }
+      for (int i = 0; i < p.m_numFirTaps; ++i)
+      {
+        out += p.m_fir[i]*in;
+        m_x[i] = in;
+      }
+      return out;
+    }
+
+  private:
+    double m_s1[MaxSections];
+    double m_s2[MaxSections];
+    double m_x[MaxFirTaps];   // x[n-1], x[n-2], ... for the FIR term
+  };
+
+  ParallelForm ()
+    : m_numSections (0)
+    , m_numFirTaps (1)
+  {
+    // identity until setup
+    m_fir[0] = 1;
+  }
+
+  explicit ParallelForm (const Cascade& cascade)
+  {
+    setup (cascade);
+  }
+
+  // Expand a designed cascade. It may have at most MaxStages stages,
+  // and its poles must be distinct.
+  void setup (const Cascade& cascade)
+  {
+    const int numStages = cascade.getNumStages ();
+    assert (numStages <= MaxStages);
+
+    // poles of every stage, in stage order, and the numerator degree
+    complex_t pole[2 * MaxStages];
+    int stagePoles[MaxStages];
+    int numPoles = 0;
+    int numeratorDegree = 0;
+    for (int i = 0; i < numStages; ++i)
+    {
+      const Cascade::Stage& s = cascade[i];
+      if (s.m_a2 != 0)
+      {
+        const complex_t d = std::sqrt (complex_t (s.m_a1*s.m_a1 - 4*s.m_a2));
+        pole[numPoles++] = (-s.m_a1 + d) * 0.5;
+        pole[numPoles++] = (-s.m_a1 - d) * 0.5;
+        stagePoles[i] = 2;
+      }
+      else if (s.m_a1 != 0)
+      {
+        pole[numPoles++] = -s.m_a1;
+        stagePoles[i] = 1;
+      }
+      else
+      {
+        stagePoles[i] = 0;
+      }
+      numeratorDegree += (s.m_b2 != 0) ? 2 : (s.m_b1 != 0) ? 1 : 0;
+    }
+
+    // residue of each pole: (1 - p z^-1) H(z) at z = p
+    complex_t residue[2 * MaxStages];
+    for (int k = 0; k < numPoles; ++k)
+    {
+      const complex_t w = 1. / pole[k];
+      complex_t r = 1;
+      for (int i = 0; i < numStages; ++i)
+      {
+        const Cascade::Stage& s = cascade[i];
+        r *= s.m_b0 + w * (s.m_b1 + w * s.m_b2);
+      }
+      for (int j = 0; j < numPoles; ++j)
+      {
+        if (j != k)
+        {
+          // Checked in release builds too: the residue would be infinite
+          if (pole[j] == pole[k])
+            throw std::logic_error ("repeated pole in parallel form expansion");
+          r /= 1. - pole[j] * w;
+        }
+      }
+      residue[k] = r;
+    }
+
+    // combine the residues of each stage's poles over its denominator
+    m_numSections = 0;
+    for (int i = 0, k = 0; i < numStages; k += stagePoles[i], ++i)
+    {
+      const Cascade::Stage& s = cascade[i];
+      const int n = m_numSections;
+      if (stagePoles[i] == 2)
+      {
+        m_c0[n] = (residue[k] + residue[k + 1]).real ();
+        m_c1[n] = -(residue[k] * pole[k + 1] + residue[k + 1] * pole[k]).real ();
+        m_a1[n] = s.m_a1;
+        m_a2[n] = s.m_a2;
+        ++m_numSections;
+      }
+      else if (stagePoles[i] == 1)
+      {
+        m_c0[n] = residue[k].real ();
+        m_c1[n] = 0;
+        m_a1[n] = s.m_a1;
+        m_a2[n] = 0;
+        ++m_numSections;
+      }
+    }
+
+    // FIR term: what remains of the impulse response once the sections
+    // are subtracted. It is nonzero only for the first few samples.
+    m_numFirTaps = std::max (1, numeratorDegree - numPoles + 1);
+    BasicDirectFormII <double> impulseState[MaxStages];
+    double x = 1;
+    for (int n = 0; n < m_numFirTaps; ++n, x = 0)
+    {
+      double h = x;
+      for (int i = 0; i < numStages; ++i)
+        h = impulseState[i].process1 (h, cascade[i], 0);
+      complex_t sections = 0;
+      for (int k = 0; k < numPoles; ++k)
+        sections += residue[k] * std::pow (pole[k], n);
+      m_fir[n] = h - sections.real ();
+    }
+  }
+
+  int getNumSections () const
+  {
+    return m_numSections;
+  }
+
+  int getNumFirTaps () const
+  {
+    return m_numFirTaps;
+  }
+
+  // Calculate filter response at the given normalized frequency.
+  complex_t response (double normalizedFrequency) const
+  {
+    const double w = 2 * doublePi * normalizedFrequency;
+    const complex_t czn1 = std::polar (1., -w);
+    const complex_t czn2 = std::polar (1., -2 * w);
+
+    complex_t h = 0;
+    for (int i = 0; i < m_numSections; ++i)
+      h += (m_c0[i] + m_c1[i] * czn1) / (1. + m_a1[i] * czn1 + m_a2[i] * czn2);
+    complex_t zn = 1;
+    for (int i = 0; i < m_numFirTaps; ++i, zn *= czn1)
+      h += m_fir[i] * zn;
+    return h;
+  }
+
+  // Process a block of samples. With a single FIR tap (the usual case)
+  // the section count is dispatched to a kernel where it is a compile
+  // time constant, so the section states stay in registers for the
+  // whole block and the sections' recursions run side by side.
+  template <typename Sample>
+  void process (int numSamples, Sample* dest, State& state) const
+  {
+    if (m_numFirTaps == 1)
+    {
+      SectionsKernel <MaxSections>::process (numSamples, dest, state, *this);
+      return;
+    }
+
+    while (--numSamples >= 0) {
+      *dest = state.process (*dest, *this);
+      dest++;
+    }
+  }
+
+private:
+  // Finds the kernel for the active section count
+  template <int Sections, int Dummy = 0>
+  struct SectionsKernel
+  {
+    template <typename Sample>
+    static void process (int numSamples, Sample* dest, State& state,
+                         const ParallelForm& p)
+    {
+      if (p.m_numSections == Sections)
+        state.template processSections <Sections> (numSamples, dest, p);
+      else
+        SectionsKernel <Sections - 1>::process (numSamples, dest, state, p);
+    }
+  };
+
+  template <int Dummy>
+  struct SectionsKernel <0, Dummy>
+  {
+    template <typename Sample>
+    static void process (int numSamples, Sample* dest, State& state,
+                         const ParallelForm& p)
+    {
+      state.template processSections <0> (numSamples, dest, p);
+    }
+  };
+
+  alignas (16) double m_c0[MaxSections];
+  alignas (16) double m_c1[MaxSections];
+  alignas (16) double m_a1[MaxSections];
+  alignas (16) double m_a2[MaxSections];
+  double m_fir[MaxFirTaps];
+  int m_numSections;
+  int m_numFirTaps;
+};
+
+}
+
+#endif
@@ -109,6 +109,11 @@ template <class BaseClass,
 struct PoleFilter : BaseClass
                   , CascadeStages <(MaxDigitalPoles + 1) / 2>
 {
+  enum
+  {
+    MaxStages = (MaxDigitalPoles + 1) / 2
+  };
+
   PoleFilter ()
   {
     // This glues together the factored base classes
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #define DSPFILTERS_SMOOTHEDFILTER_H
 
 #include "DspFilters/Common.h"
+#include "DspFilters/Cascade.h"
 #include "DspFilters/Filter.h"
 
 namespace Dsp {
@@ -149,6 +150,110 @@ protected:
   int m_remainingSamples;        // remaining transition samples
 };
 
+//------------------------------------------------------------------------------
+
+/*
+ * Smooth modulation like SmoothedFilterDesign, but the filter is only
+ * designed once per parameter change. The transition interpolates the
+ * old and new coefficients in the lattice domain (see CascadeTransition)
+ * instead of redesigning the filter for every sample, which makes live
+ * retuning affordable. Requires a pole filter design (one that exposes
+ * MaxStages), since the old and new designs are paired stage by stage.
+ *
+ */
+template <class DesignClass,
+          int Channels,
+          class StateType = DirectFormII>
+class InterpolatedFilterDesign
+  : public FilterDesign <DesignClass,
+                       Channels,
+                       StateType>
+{
+public:
+  typedef FilterDesign <DesignClass, Channels, StateType> filter_type_t;
+
+  InterpolatedFilterDesign (int transitionSamples)
+    : m_transitionSamples (transitionSamples)
+    , m_designed (false)
+  {
+  }
+
+  // Process a block of samples.
+  template <typename Sample>
+  void processBlock (int numSamples,
+                     Sample* const* destChannelArray)
+  {
+    const int numChannels = this->getNumChannels();
+
+    // If this goes off it means setup() was never called
+    assert (m_designed);
+
+    // first handle any transition samples
+    int remainingSamples = std::min (m_transition.getRemainingSamples (), numSamples);
+
+    for (int n = 0; n < remainingSamples; ++n)
+    {
+      m_transition.advance ();
+
+      for (int i = numChannels; --i >= 0;)
+      {
+        Sample* dest = destChannelArray[i]+n;
+        *dest = this->m_state[i].process (*dest, m_transition);
+      }
+    }
+
+    // do what's left
+    if (numSamples - remainingSamples > 0)
+    {
+      // no transition
+      for (int i = 0; i < numChannels; ++i)
+        this->m_design.process (numSamples - remainingSamples,
+                          destChannelArray[i] + remainingSamples,
+                          this->m_state[i]);
+    }
+  }
+
+  void process (int numSamples, float* const* arrayOfChannels)
+  {
+    processBlock (numSamples, arrayOfChannels);
+  }
+
+  void process (int numSamples, double* const* arrayOfChannels)
+  {
+    processBlock (numSamples, arrayOfChannels);
+  }
+
+protected:
+  void doSetParams (const Params& parameters)
+  {
+    if (!m_designed)
+    {
+      // first time
+      filter_type_t::doSetParams (parameters);
+      m_designed = true;
+      return;
+    }
+
+    // snapshot the coefficients in effect now, which may be part way
+    // through a running transition
+    if (m_transition.getRemainingSamples () == 0)
+      m_transition.setup (this->m_design, this->m_design, 0);
+
+    filter_type_t::doSetParams (parameters);
+
+    // a change of order cannot be interpolated stage by stage
+    if (m_transition.getNumStages () == this->m_design.getNumStages ())
+      m_transition.setup (m_transition, this->m_design, m_transitionSamples);
+    else
+      m_transition.setup (this->m_design, this->m_design, 0);
+  }
+
+protected:
+  CascadeTransition <DesignClass::MaxStages> m_transition;
+  int m_transitionSamples;
+  bool m_designed;
+};
+
 }
 
 #endif
@@ -38,6 +38,7 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 #include "DspFilters/Biquad.h"
+#include "DspFilters/LanePack.h"
 
 #include <stdexcept>
 
@@ -47,8 +48,116 @@ namespace Dsp {
  * Various forms of state information required to
  * process channels of actual sample data.
  *
+ * The common forms are templates on the precision of the stored state
+ * (float or double). process1 accepts either the double precision
+ * coefficients of a BiquadBase or a BiquadCoefficients copy in the
+ * state's own precision. The usual names are the double precision
+ * instantiations.
+ *
+ */
+
+//------------------------------------------------------------------------------
+
+/*
+ * Block kernels for stage-major processing (processBlock1 of the state
+ * forms, driven by Cascade::StateBase::processBlock).
+ *
+ * Processing one section over a whole block makes its recursion the
+ * critical path: y[n] cannot start before y[n-1] is done, so a plain
+ * loop is slower than sample-major processing, where the recursions of
+ * different stages overlap. The blocks are therefore split into the
+ * feed-forward part, whose samples are independent, and the all-pole
+ * recursion
+ *
+ *   y[n] = f[n] - a1*y[n-1] - a2*y[n-2]
+ *
+ * which is advanced four samples at a time. With h[k] the impulse
+ * response of the recursion and P[k], Q[k] its response to the two
+ * previous outputs,
+ *
+ *   y[n+k] = sum (j <= k) h[j]*f[n+k-j] + P[k]*y[n-1] + Q[k]*y[n-2]
+ *
+ * so all four outputs of a step depend only on the previous step, and
+ * the dependency chain per sample is a quarter as long. Results equal
+ * process1 to rounding.
+ *
  */
 
+// dest[n] <- b0*dest[n] + b1*dest[n-1] + b2*dest[n-2], x1 x2 hold the
+// two inputs before the block and receive the last two of the block.
+// Runs backwards so the inputs are still intact when they are read.
+template <typename Real>
+inline void firBlock (int numSamples, double* dest,
+                      const Real b0, const Real b1, const Real b2,
+                      Real& x1, Real& x2)
+{
+  if (numSamples <= 0)
+    return;
+
+  const Real last1 = static_cast<Real> (dest[numSamples - 1]);
+  const Real last2 = (numSamples > 1) ? static_cast<Real> (dest[numSamples - 2]) : x1;
+  for (int i = numSamples - 1; i >= 2; --i)
+    dest[i] = b0*static_cast<Real> (dest[i]) + b1*static_cast<Real> (dest[i - 1])
+            + b2*static_cast<Real> (dest[i - 2]);
+  if (numSamples > 1)
+    dest[1] = b0*static_cast<Real> (dest[1]) + b1*static_cast<Real> (dest[0]) + b2*x1;
+  dest[0] = b0*static_cast<Real> (dest[0]) + b1*x1 + b2*x2;
+
+  x1 = last1;
+  x2 = last2;
+}
+
+// dest[n] <- dest[n] - a1*y[n-1] - a2*y[n-2], y1 y2 hold the two outputs
+// before the block and receive the last two of the block.
+template <typename Real>
+inline void allPoleBlock (int numSamples, double* dest,
+                          const Real a1, const Real a2,
+                          Real& y1, Real& y2)
+{
+  const Real h1 = -a1;
+  const Real h2 = -a1*h1 - a2;
+  const Real h3 = -a1*h2 - a2*h1;
+  const Real p0 = -a1,          q0 = -a2;
+  const Real p1 = -a1*p0 - a2,  q1 = -a1*q0;
+  const Real p2 = -a1*p1 - a2*p0, q2 = -a1*q1 - a2*q0;
+  const Real p3 = -a1*p2 - a2*p1, q3 = -a1*q2 - a2*q1;
+
+  Real prev1 = y1, prev2 = y2; // locals, so they cannot alias dest
+  int i = 0;
+  for (; i + 3 < numSamples; i += 4)
+  {
+    const Real f0 = static_cast<Real> (dest[i]);
+    const Real f1 = static_cast<Real> (dest[i + 1]);
+    const Real f2 = static_cast<Real> (dest[i + 2]);
+    const Real f3 = static_cast<Real> (dest[i + 3]);
+    const Real g1 = f1 + h1*f0;
+    const Real g2 = f2 + h1*f1 + h2*f0;
+    const Real g3 = f3 + h1*f2 + h2*f1 + h3*f0;
+
+    // the prev1 terms are added last, they are on the critical path
+    const Real out0 = (f0 + q0*prev2) + p0*prev1;
+    const Real out1 = (g1 + q1*prev2) + p1*prev1;
+    const Real out2 = (g2 + q2*prev2) + p2*prev1;
+    const Real out3 = (g3 + q3*prev2) + p3*prev1;
+    dest[i] = out0;
+    dest[i + 1] = out1;
+    dest[i + 2] = out2;
+    dest[i + 3] = out3;
+    prev2 = out2;
+    prev1 = out3;
+  }
+  for (; i < numSamples; ++i)
+  {
+    const Real out = (static_cast<Real> (dest[i]) - a2*prev2) - a1*prev1;
+    dest[i] = out;
+    prev2 = prev1;
+    prev1 = out;
+  }
+
+  y1 = prev1;
+  y2 = prev2;
+}
+
 //------------------------------------------------------------------------------
 
 /*
@@ -59,10 +168,13 @@ namespace Dsp {
  *  y[n] = (b0/a0)*x[n] + (b1/a0)*x[n-1] + (b2/a0)*x[n-2]
  *                      - (a1/a0)*y[n-1] - (a2/a0)*y[n-2]  
  */
-class DirectFormI
+template <typename Real>
+class BasicDirectFormI
 {
 public:
-  DirectFormI ()
+  typedef Real value_type;
+
+  BasicDirectFormI ()
   {
     reset();
   }
@@ -75,29 +187,71 @@ public:
     m_y2 = 0;
   }
 
-  template <typename Sample>
+  template <typename Sample, class Coefficients>
   inline Sample process1 (const Sample in,
-                          const BiquadBase& s,
+                          const Coefficients& s,
                           const double vsa) // very small amount
   {
-    double out = s.m_b0*in + s.m_b1*m_x1 + s.m_b2*m_x2
-                           - s.m_a1*m_y1 - s.m_a2*m_y2
-                           + vsa;
+    Real out = static_cast<Real> (s.m_b0)*in
+             + static_cast<Real> (s.m_b1)*m_x1
+             + static_cast<Real> (s.m_b2)*m_x2
+             - static_cast<Real> (s.m_a1)*m_y1
+             - static_cast<Real> (s.m_a2)*m_y2
+             + static_cast<Real> (vsa);
     m_x2 = m_x1;
     m_y2 = m_y1;
-    m_x1 = in;
+    m_x1 = static_cast<Real> (in);
     m_y1 = out;
 
     return static_cast<Sample> (out);
   }
 
+  // Whole block through this section alone, for stage-major processing.
+  // No denormal offset here, the cascade adds it once per block.
+  template <class Coefficients>
+  void processBlock1 (int numSamples, double* dest, const Coefficients& s)
+  {
+    firBlock (numSamples, dest, static_cast<Real> (s.m_b0),
+              static_cast<Real> (s.m_b1), static_cast<Real> (s.m_b2),
+              m_x1, m_x2);
+    allPoleBlock (numSamples, dest, static_cast<Real> (s.m_a1),
+                  static_cast<Real> (s.m_a2), m_y1, m_y2);
+  }
+
+  // Steady state for a constant input. Returns the constant output.
+  template <class Coefficients>
+  double setSteadyState (const double in, const Coefficients& s)
+  {
+    const double den = 1 + s.m_a1 + s.m_a2;
+    const double out = (den != 0) ? in * (s.m_b0 + s.m_b1 + s.m_b2) / den : 0;
+    m_x1 = m_x2 = static_cast<Real> (in);
+    m_y1 = m_y2 = static_cast<Real> (out);
+    return out;
+  }
+
+  enum { StateSize = 4 };
+
+  void getState (double* dest) const
+  {
+    dest[0] = m_x1; dest[1] = m_x2; dest[2] = m_y1; dest[3] = m_y2;
+  }
+
+  void setState (const double* src)
+  {
+    m_x1 = static_cast<Real> (src[0]); m_x2 = static_cast<Real> (src[1]);
+    m_y1 = static_cast<Real> (src[2]); m_y2 = static_cast<Real> (src[3]);
+  }
+
 protected:
-  double m_x2; // x[n-2]
-  double m_y2; // y[n-2]
-  double m_x1; // x[n-1]
-  double m_y1; // y[n-1]
+  Real m_x2; // x[n-2]
+  Real m_y2; // y[n-2]
+  Real m_x1; // x[n-1]
+  Real m_y1; // y[n-1]
 };
 
+typedef BasicDirectFormI <double> DirectFormI;
+typedef BasicDirectFormI <float>  DirectFormIFloat;
+
 //------------------------------------------------------------------------------
 
 /*
@@ -109,10 +263,13 @@ protected:
  *  y(n) = (b0/a0)*v[n] + (b1/a0)*v[n-1] + (b2/a0)*v[n-2]
  *
  */
-class DirectFormII
+template <typename Real>
+class BasicDirectFormII
 {
 public:
-  DirectFormII ()
+  typedef Real value_type;
+
+  BasicDirectFormII ()
   {
     reset ();
   }
@@ -123,13 +280,16 @@ public:
     m_v2 = 0;
   }
 
-  template <typename Sample>
+  template <typename Sample, class Coefficients>
   Sample process1 (const Sample in,
-                   const BiquadBase& s,
+                   const Coefficients& s,
                    const double vsa)
   {
-    double w   = in - s.m_a1*m_v1 - s.m_a2*m_v2 + vsa;
-    double out =      s.m_b0*w    + s.m_b1*m_v1 + s.m_b2*m_v2;
+    Real w   = in - static_cast<Real> (s.m_a1)*m_v1
+                  - static_cast<Real> (s.m_a2)*m_v2 + static_cast<Real> (vsa);
+    Real out =      static_cast<Real> (s.m_b0)*w
+                  + static_cast<Real> (s.m_b1)*m_v1
+                  + static_cast<Real> (s.m_b2)*m_v2;
 
     m_v2 = m_v1;
     m_v1 = w;
@@ -137,11 +297,54 @@ public:
     return static_cast<Sample> (out);
   }
 
+  // Whole block through this section alone (see BasicDirectFormI)
+  template <class Coefficients>
+  void processBlock1 (int numSamples, double* dest, const Coefficients& s)
+  {
+    const Real b0 = static_cast<Real> (s.m_b0);
+    const Real b1 = static_cast<Real> (s.m_b1);
+    const Real b2 = static_cast<Real> (s.m_b2);
+    const Real a1 = static_cast<Real> (s.m_a1);
+    const Real a2 = static_cast<Real> (s.m_a2);
+    // poles first, then zeros, over the same v[-1] v[-2] history
+    Real v1 = m_v1, v2 = m_v2;
+    allPoleBlock (numSamples, dest, a1, a2, m_v1, m_v2);
+    firBlock (numSamples, dest, b0, b1, b2, v1, v2);
+  }
+
+  // Steady state for a constant input. Returns the constant output.
+  // The internal node settles at in / (1 + a1 + a2), which is large for
+  // poles near DC; a pole exactly at DC has no steady state and the
+  // section is left at zero.
+  template <class Coefficients>
+  double setSteadyState (const double in, const Coefficients& s)
+  {
+    const double den = 1 + s.m_a1 + s.m_a2;
+    const double w = (den != 0) ? in / den : 0;
+    m_v1 = m_v2 = static_cast<Real> (w);
+    return (s.m_b0 + s.m_b1 + s.m_b2) * w;
+  }
+
+  enum { StateSize = 2 };
+
+  void getState (double* dest) const
+  {
+    dest[0] = m_v1; dest[1] = m_v2;
+  }
+
+  void setState (const double* src)
+  {
+    m_v1 = static_cast<Real> (src[0]); m_v2 = static_cast<Real> (src[1]);
+  }
+
 private:
-  double m_v1; // v[-1]
-  double m_v2; // v[-2]
+  Real m_v1; // v[-1]
+  Real m_v2; // v[-2]
 };
 
+typedef BasicDirectFormII <double> DirectFormII;
+typedef BasicDirectFormII <float>  DirectFormIIFloat;
+
 //------------------------------------------------------------------------------
 
 /*
@@ -212,10 +415,13 @@ private:
 
 //------------------------------------------------------------------------------
 
-class TransposedDirectFormII
+template <typename Real>
+class BasicTransposedDirectFormII
 {
 public:
-  TransposedDirectFormII ()
+  typedef Real value_type;
+
+  BasicTransposedDirectFormII ()
   {
     reset ();
   }
@@ -228,27 +434,211 @@ public:
     m_s2_1 = 0;
   }
 
-  template <typename Sample>
+  template <typename Sample, class Coefficients>
   inline Sample process1 (const Sample in,
-                          const BiquadBase& s,
+                          const Coefficients& s,
                           const double vsa)
   {
-    double out;
+    Real out;
 
-    out = m_s1_1 + s.m_b0*in + vsa;
-    m_s1 = m_s2_1 + s.m_b1*in - s.m_a1*out;
-    m_s2 = s.m_b2*in - s.m_a2*out;
+    out = m_s1_1 + static_cast<Real> (s.m_b0)*in + static_cast<Real> (vsa);
+    m_s1 = m_s2_1 + static_cast<Real> (s.m_b1)*in - static_cast<Real> (s.m_a1)*out;
+    m_s2 = static_cast<Real> (s.m_b2)*in - static_cast<Real> (s.m_a2)*out;
     m_s1_1 = m_s1;
     m_s2_1 = m_s2;
 
     return static_cast<Sample> (out);
   }
 
+  // Whole block through this section alone (see BasicDirectFormI)
+  template <class Coefficients>
+  void processBlock1 (int numSamples, double* dest, const Coefficients& s)
+  {
+    const Real b0 = static_cast<Real> (s.m_b0);
+    const Real b1 = static_cast<Real> (s.m_b1);
+    const Real b2 = static_cast<Real> (s.m_b2);
+    const Real a1 = static_cast<Real> (s.m_a1);
+    const Real a2 = static_cast<Real> (s.m_a2);
+    if (numSamples < 2)
+    {
+      if (numSamples == 1)
+        dest[0] = process1 (dest[0], s, 0);
+      return;
+    }
+
+    // The first two samples are exact transposed steps. After that the
+    // last two inputs and outputs are known, which is all the direct
+    // form block kernels need.
+    Real x2 = static_cast<Real> (dest[0]);
+    Real y2 = process1 (x2, s, 0);
+    Real x1 = static_cast<Real> (dest[1]);
+    Real y1 = process1 (x1, s, 0);
+    dest[0] = y2;
+    dest[1] = y1;
+
+    firBlock (numSamples - 2, dest + 2, b0, b1, b2, x1, x2);
+    allPoleBlock (numSamples - 2, dest + 2, a1, a2, y1, y2);
+
+    // back to transposed state
+    const Real s2_1 = b2*x2 - a2*y2;
+    m_s1 = m_s1_1 = s2_1 + b1*x1 - a1*y1;
+    m_s2 = m_s2_1 = b2*x1 - a2*y1;
+  }
+
+  // Steady state for a constant input (scipy's lfilter_zi * in).
+  // Returns the constant output. A pole exactly at DC gives the
+  // section no finite DC gain; it is treated as a zero gain.
+  template <class Coefficients>
+  double setSteadyState (const double in, const Coefficients& s)
+  {
+    const double den = 1 + s.m_a1 + s.m_a2;
+    const double gain = (den != 0) ? (s.m_b0 + s.m_b1 + s.m_b2) / den : 0;
+    const double out = gain * in;
+    const double s2 = s.m_b2 * in - s.m_a2 * out;
+    const double s1 = s.m_b1 * in - s.m_a1 * out + s2;
+    m_s1 = m_s1_1 = static_cast<Real> (s1);
+    m_s2 = m_s2_1 = static_cast<Real> (s2);
+    return out;
+  }
+
+  enum { StateSize = 2 };
+
+  void getState (double* dest) const
+  {
+    dest[0] = m_s1_1; dest[1] = m_s2_1;
+  }
+
+  void setState (const double* src)
+  {
+    m_s1 = m_s1_1 = static_cast<Real> (src[0]);
+    m_s2 = m_s2_1 = static_cast<Real> (src[1]);
+  }
+
 private:
-  double m_s1;
-  double m_s1_1;
-  double m_s2;
-  double m_s2_1;
+  Real m_s1;
+  Real m_s1_1;
+  Real m_s2;
+  Real m_s2_1;
+};
+
+typedef BasicTransposedDirectFormII <double> TransposedDirectFormII;
+typedef BasicTransposedDirectFormII <float>  TransposedDirectFormIIFloat;
+
+//------------------------------------------------------------------------------
+
+/*
+ * Direct Form II state for several channels that share one set of
+ * coefficients. The state of each channel lives in its own lane, and
+ * process1 updates a whole LanePack of lanes per instruction: 4 doubles
+ * or 8 floats with AVX, 2 doubles or 4 floats with SSE2. Lane counts that
+ * are not a multiple of the pack width fall back to a scalar loop.
+ *
+ * A frame is an array of Lanes samples, one per channel, filtered in place.
+ *
+ */
+template <int Lanes, typename Real = double>
+class LanesDirectFormII
+{
+public:
+  enum
+  {
+    NumLanes = Lanes
+  };
+
+  LanesDirectFormII ()
+  {
+    reset ();
+  }
+
+  void reset ()
+  {
+    for (int i = 0; i < Lanes; ++i)
+    {
+      m_v1[i] = 0;
+      m_v2[i] = 0;
+    }
+  }
+
+  template <class Coefficients>
+  inline void process1 (Real* frame,
+                        const Coefficients& s,
+                        const double vsa)
+  {
+    typedef LanePack <Real> P;
+    const int step = (Lanes % P::Width) == 0 ? P::Width : 1;
+
+    if (step == 1)
+    {
+      process1Scalar (frame, s, vsa);
+      return;
+    }
+
+    const typename P::type a1 = P::set1 (static_cast<Real> (s.m_a1));
+    const typename P::type a2 = P::set1 (static_cast<Real> (s.m_a2));
+    const typename P::type b0 = P::set1 (static_cast<Real> (s.m_b0));
+    const typename P::type b1 = P::set1 (static_cast<Real> (s.m_b1));
+    const typename P::type b2 = P::set1 (static_cast<Real> (s.m_b2));
+    const typename P::type v  = P::set1 (static_cast<Real> (vsa));
+
+    for (int i = 0; i < Lanes; i += step)
+    {
+      const typename P::type x  = P::load (frame + i);
+      const typename P::type v1 = P::load (m_v1 + i);
+      const typename P::type v2 = P::load (m_v2 + i);
+
+      // w = x - a1*v1 - a2*v2 + vsa
+      const typename P::type w = P::add (P::sub (P::sub (x,
+        P::mul (a1, v1)), P::mul (a2, v2)), v);
+      // y = b0*w + b1*v1 + b2*v2
+      const typename P::type y = P::add (P::add (P::mul (b0, w),
+        P::mul (b1, v1)), P::mul (b2, v2));
+
+      P::store (frame + i, y);
+      P::store (m_v2 + i, v1);
+      P::store (m_v1 + i, w);
+    }
+  }
+
+  // Steady state of every lane for the constant inputs in frame.
+  // The frame is replaced by the constant outputs.
+  template <class Coefficients>
+  void setSteadyState (Real* frame, const Coefficients& s)
+  {
+    const double den = 1 + s.m_a1 + s.m_a2;
+    const double gain = s.m_b0 + s.m_b1 + s.m_b2;
+    for (int i = 0; i < Lanes; ++i)
+    {
+      const double w = (den != 0) ? frame[i] / den : 0;
+      m_v1[i] = m_v2[i] = static_cast<Real> (w);
+      frame[i] = static_cast<Real> (gain * w);
+    }
+  }
+
+private:
+  template <class Coefficients>
+  void process1Scalar (Real* frame,
+                       const Coefficients& s,
+                       const double vsa)
+  {
+    const Real a1 = static_cast<Real> (s.m_a1);
+    const Real a2 = static_cast<Real> (s.m_a2);
+    const Real b0 = static_cast<Real> (s.m_b0);
+    const Real b1 = static_cast<Real> (s.m_b1);
+    const Real b2 = static_cast<Real> (s.m_b2);
+    const Real v  = static_cast<Real> (vsa);
+
+    for (int i = 0; i < Lanes; ++i)
+    {
+      const Real w = frame[i] - a1*m_v1[i] - a2*m_v2[i] + v;
+      frame[i] = b0*w + b1*m_v1[i] + b2*m_v2[i];
+      m_v2[i] = m_v1[i];
+      m_v1[i] = w;
+    }
+  }
+
+private:
+  Real m_v1[Lanes]; // v[-1] per lane
+  Real m_v2[Lanes]; // v[-2] per lane
 };
 
 //------------------------------------------------------------------------------
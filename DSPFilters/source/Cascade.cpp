@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "DspFilters/Common.h"
 #include "DspFilters/Cascade.h"
 
+#include <stdexcept>
+
 namespace Dsp {
 
 Cascade::Cascade ()
@@ -92,6 +94,16 @@ std::vector<PoleZeroPair> Cascade::getPoleZeros () const
   return vpz;
 }
 
+void Cascade::setStages (const Biquad* stages, int numStages)
+{
+  // Checked in release builds too: an overrun would write past m_stageArray
+  if (numStages < 1 || numStages > m_maxStages)
+    throw std::logic_error ("stage count does not fit this cascade");
+  m_numStages = numStages;
+  for (int i = 0; i < numStages; ++i)
+    static_cast<Biquad&> (m_stageArray[i]) = stages[i];
+}
+
 void Cascade::applyScale (double scale)
 {
   // For higher order filters it might be helpful
@@ -0,0 +1,103 @@
+#ifndef CASCADE_KERNEL_HPP
+#define CASCADE_KERNEL_HPP
+
+#include "DspFilters/Dsp.h"
+#include "filter_design_cache.hpp"
+#include <cstddef>
+
+namespace ppg
+{
+
+    /**
+     * @brief 运行时选择节数的展开级联内核（按块类型擦除）
+     *
+     * 滤波器族和阶数可在运行时由配置决定（FilterDesignCache 设计后只剩
+     * biquad系数），但不同设计的节数不同。本类为 1 ~ kMaxStages 节各实例化
+     * 一个编译期展开的DF-II块内核（Dsp::FixedCascadeSections），setup 时按
+     * 节数选定函数指针：每块只有一次间接调用，块内没有虚函数调用、节循环
+     * 或指针追逐。系数与状态存放在定长数组中，不分配堆内存。
+     *
+     * 状态布局与 Cascade::StateBase::getState（DirectFormII）一致，
+     * 可与通用级联互相交接。
+     */
+    class CascadeKernel
+    {
+    public:
+        /// 支持的最大节数（带通设计每阶一节）
+        static const int kMaxStages = FilterDesignCache::kMaxOrder;
+
+        /**
+         * @brief 构造直通内核（0节，输出等于输入）
+         */
+        CascadeKernel();
+
+        /**
+         * @brief 载入级联系数并选定对应节数的块内核，状态清零
+         * @throws std::invalid_argument 节数超过 kMaxStages
+         */
+        void setup(const Dsp::Cascade &cascade);
+
+        /**
+         * @brief 载入缓存中的设计
+         * @throws std::invalid_argument 节数超过 kMaxStages
+         */
+        void setup(const BandPassDesign &design);
+
+        /**
+         * @brief 当前节数
+         */
+        int num_stages() const { return num_stages_; }
+
+        /**
+         * @brief 处理单个样本（节循环，无间接调用）
+         *
+         * 非规格化数的处理同 process_block，但每个样本都要设置并恢复一次
+         * FTZ/DAZ（约10ns）。连续数据请用 process_block；必须逐样本调用时，
+         * 在循环外持有 denormal_policy::Scope，循环内只读取MXCSR。
+         */
+        float process_sample(float input);
+
+        /**
+         * @brief 原地处理一个样本块（一次间接调用，块内为展开内核）
+         *
+         * 非规格化数按 Dsp::DenormalRealtime 处理：有MXCSR的平台在块内设置
+         * FTZ/DAZ、返回前恢复，不再逐样本注入；其他平台逐样本注入vsa。
+         */
+        void process_block(float *data, size_t n);
+
+        /**
+         * @brief 状态清零
+         */
+        void reset();
+
+        /**
+         * @brief 设置为直流输入 dc_value 下的稳态
+         * @return 稳态输出
+         */
+        double prime(double dc_value);
+
+        /**
+         * @brief 导出/载入状态（每节 v[-1], v[-2]，共 2*num_stages() 个值）
+         */
+        void get_state(double *dest) const;
+        void set_state(const double *src);
+
+        /// 非规格化数处理策略
+        typedef Dsp::DenormalRealtime denormal_policy;
+
+    private:
+        static const int kCoefficientsPerStage = 5;
+
+        typedef void (*BlockFunction)(const double *coeffs, double *state,
+                                      denormal_policy &denormal, float *data, size_t n);
+
+        BlockFunction block_function_;
+        int num_stages_;
+        denormal_policy denormal_;                              // 提供逐样本注入量 ac()
+        alignas(16) double coeffs_[kCoefficientsPerStage * kMaxStages]; // b0 b1 b2 a1 a2
+        double state_[2 * kMaxStages];
+    };
+
+} // namespace ppg
+
+#endif // CASCADE_KERNEL_HPP
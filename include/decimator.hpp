@@ -0,0 +1,84 @@
+#ifndef DECIMATOR_HPP
+#define DECIMATOR_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace ppg
+{
+
+    /**
+     * @brief 多相FIR整数倍抽取器（例如 1000Hz → 100Hz / 125Hz）
+     *
+     * 放在 RealtimeFilter 之后，把已带限到 passband_hz 以内的信号降到
+     * 分析所需的采样率，峰值检测、AC/DC、心率以及缓冲区的开销随之降低一个数量级。
+     *
+     * 抗混叠滤波器为Hamming窗sinc低通，截止频率为 output_rate/2，
+     * 过渡带为 [passband_hz, output_rate - passband_hz]（混叠到通带内的分量
+     * 全部落在阻带，阻带衰减约53dB）。只在需要输出的时刻计算内积，
+     * 等价于多相分解，每个输入样本平均只需 num_taps()/factor() 次乘加。
+     */
+    class Decimator
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param input_rate 输入采样率 (Hz)
+         * @param output_rate 输出采样率 (Hz)，必须整除 input_rate
+         * @param passband_hz 需要无失真保留的最高频率 (Hz)，必须小于 output_rate/2
+         */
+        Decimator(double input_rate, double output_rate, double passband_hz = 20.0);
+
+        /**
+         * @brief 处理单个样本
+         * @param input 输入样本值
+         * @param output 产生输出时写入抽取后的样本
+         * @return true 表示本次产生了一个输出
+         */
+        bool process_sample(float input, float &output);
+
+        /**
+         * @brief 处理一个样本块
+         * @param in 输入样本数组
+         * @param n 输入样本数
+         * @param out 输出数组（容量至少为 n / factor() + 1）
+         * @return 写入 out 的输出样本数
+         */
+        size_t process_block(const float *in, size_t n, float *out);
+
+        /**
+         * @brief 以常数值填充延迟线（相当于之前一直输入该值，消除启动瞬态）
+         * @param value 初始值（通常为信号均值）
+         */
+        void warmup(float value);
+
+        /**
+         * @brief 清空延迟线和相位
+         */
+        void reset();
+
+        /// 抽取倍数
+        int factor() const { return factor_; }
+
+        /// 输出采样率 (Hz)
+        double output_rate() const { return output_rate_; }
+
+        /// FIR抽头数
+        size_t num_taps() const { return taps_.size(); }
+
+        /// 抗混叠滤波器的群延迟（秒）
+        double delay_seconds() const { return (taps_.size() - 1) / (2.0 * input_rate_); }
+
+    private:
+        std::vector<float> taps_;     // FIR系数（按时间倒序存放，便于与延迟线直接做内积）
+        std::vector<float> history_;  // 双倍长度延迟线，保证内积区间连续
+        size_t pos_;                  // 延迟线写入位置
+        int phase_;                   // 距离下一个输出还需的输入样本数
+        int factor_;
+        double input_rate_;
+        double output_rate_;
+    };
+
+} // namespace ppg
+
+#endif // DECIMATOR_HPP
@@ -0,0 +1,115 @@
+#ifndef FILTER_CHAIN_HPP
+#define FILTER_CHAIN_HPP
+
+#include "DspFilters/Dsp.h"
+#include "filter_design_cache.hpp"
+#include <cstddef>
+
+namespace ppg
+{
+
+    /**
+     * @brief 融合滤波链：带通、工频陷波和微分合并为一个级联
+     *
+     * 各环节的biquad依次追加到同一个 Dsp::CascadeChain 中，只有一份状态、
+     * 每个样本只遍历一次。需要中间信号（如微分之前的带通信号）时，在相应
+     * 环节之后调用 tap()，处理时同一遍中把该节的输出写入抽头缓冲区。
+     *
+     * 用法：
+     * @code
+     *   ppg::FusedFilterChain chain(fs);
+     *   chain.add_bandpass(ppg::BandPassSpec(0.5, 20.0, fs));
+     *   chain.add_notch(50.0);
+     *   int filtered = chain.tap();        // 带通+陷波后的信号
+     *   chain.add_derivative();            // 最终输出为其导数
+     *   float *taps[] = { filtered_buffer };
+     *   chain.process_block(data, n, taps);
+     * @endcode
+     *
+     * 追加环节会清零状态。
+     */
+    class FusedFilterChain
+    {
+    public:
+        /// 链中最大节数
+        static const int kMaxStages = 16;
+
+        /**
+         * @brief 构造空链（输出等于输入）
+         * @param sample_rate 采样率 (Hz)
+         */
+        explicit FusedFilterChain(double sample_rate);
+
+        /**
+         * @brief 追加带通滤波器（设计取自 FilterDesignCache）
+         * @throws std::invalid_argument 采样率不一致或节数超过 kMaxStages
+         */
+        FusedFilterChain &add_bandpass(const BandPassSpec &spec);
+
+        /**
+         * @brief 追加工频陷波（RBJ带阻，一节）
+         * @param frequency 陷波频率 (Hz)，如 50 或 60
+         * @param q 品质因数，越大陷波越窄
+         * @throws std::invalid_argument 频率不在 (0, fs/2) 内或节数超限
+         */
+        FusedFilterChain &add_notch(double frequency, double q = 30.0);
+
+        /**
+         * @brief 追加微分器（中心差分 (x[n] - x[n-2]) * fs / 2，单位/秒，延迟一个样本）
+         * @throws std::invalid_argument 节数超限
+         */
+        FusedFilterChain &add_derivative();
+
+        /**
+         * @brief 把目前最后一节的输出设为抽头
+         * @return 抽头编号（即处理时 taps 数组的下标）
+         * @throws std::invalid_argument 链为空或该节已是抽头
+         */
+        int tap();
+
+        int num_stages() const { return chain_.getNumStages(); }
+        int num_taps() const { return num_taps_; }
+        double sample_rate() const { return sample_rate_; }
+
+        /**
+         * @brief 处理单个样本
+         * @param input 输入样本
+         * @param taps 接收各抽头当前值的数组（长度 num_taps()），无抽头时可为 nullptr
+         * @return 链末端的输出
+         */
+        float process_sample(float input, float *taps = nullptr);
+
+        /**
+         * @brief 原地处理一个样本块（级优先分块，一遍得到全部抽头）
+         * @param data 输入，返回时为链末端的输出
+         * @param n 样本数
+         * @param taps taps[j] 为第 j 个抽头的输出缓冲区（长度至少为 n），无抽头时可为 nullptr
+         */
+        void process_block(float *data, size_t n, float *const *taps = nullptr);
+
+        /**
+         * @brief 状态清零
+         */
+        void reset();
+
+        /**
+         * @brief 设置为直流输入 dc_value 下的稳态
+         * @return 稳态输出
+         */
+        double prime(double dc_value);
+
+    private:
+        typedef Dsp::CascadeChain<kMaxStages> chain_type;
+
+        void check_room(int stages) const;
+
+        double sample_rate_;
+        chain_type chain_;
+        chain_type::State<Dsp::DirectFormII> state_;
+        unsigned int tap_mask_;     // 第 i 位表示第 i 节的输出为抽头
+        int num_taps_;
+    };
+
+} // namespace ppg
+
+#endif // FILTER_CHAIN_HPP
@@ -0,0 +1,159 @@
+#ifndef FILTER_DESIGN_CACHE_HPP
+#define FILTER_DESIGN_CACHE_HPP
+
+#include "DspFilters/Dsp.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ppg
+{
+
+    /**
+     * @brief 滤波器族
+     */
+    enum class FilterFamily
+    {
+        Butterworth,    // 通带最平坦
+        ChebyshevI,     // 通带等纹波，过渡带更陡
+        ChebyshevII,    // 阻带等纹波，通带平坦
+        Elliptic,       // 通带、阻带均等纹波，同阶数下过渡带最陡
+        Bessel,         // 群延迟最平坦，波形失真最小
+        Legendre        // 单调通带下过渡带最陡
+    };
+
+    /**
+     * @brief 滤波器族名称（与 parse_filter_family 接受的名称一致）
+     */
+    const char *filter_family_name(FilterFamily family);
+
+    /**
+     * @brief 由名称解析滤波器族（不区分大小写），用于配置驱动的滤波器选择
+     *
+     * 接受 "butterworth"、"chebyshev1"、"chebyshev2"、"elliptic"、"bessel"、
+     * "legendre"，以及 "chebyshevi"、"chebyshevii" 等别名。
+     *
+     * @throws std::invalid_argument 未知名称
+     */
+    FilterFamily parse_filter_family(const std::string &name);
+
+    /**
+     * @brief 带通滤波器设计规格（族、阶数、通带以及族相关参数）
+     */
+    struct BandPassSpec
+    {
+        FilterFamily family;
+        int order;
+        double low_freq;        // 低频截止 (Hz)
+        double high_freq;       // 高频截止 (Hz)
+        double sample_rate;     // 采样率 (Hz)
+        double ripple_db;       // 通带纹波 (dB)：ChebyshevI / Elliptic
+        double stopband_db;     // 阻带衰减 (dB)：ChebyshevII
+        double rolloff;         // 过渡带陡度：Elliptic
+
+        BandPassSpec(double low, double high, double fs, int filter_order = 3,
+                     FilterFamily filter_family = FilterFamily::Butterworth)
+            : family(filter_family), order(filter_order), low_freq(low), high_freq(high),
+              sample_rate(fs), ripple_db(1.0), stopband_db(40.0), rolloff(0.0)
+        {
+        }
+    };
+
+    /**
+     * @brief 已设计好的带通滤波器（不可变的biquad系数集合）
+     *
+     * 由 FilterDesignCache 创建并以 shared_ptr<const> 共享，
+     * 多个滤波器实例可同时引用同一份系数。
+     */
+    struct BandPassDesign
+    {
+        FilterFamily family;
+        int order;
+        double sample_rate;
+        double center_frequency;
+        double bandwidth;
+        double ripple_db;
+        double stopband_db;
+        double rolloff;
+        std::vector<Dsp::Biquad> stages; // 级联二阶节系数
+
+        int num_stages() const { return static_cast<int>(stages.size()); }
+    };
+
+    typedef std::shared_ptr<const BandPassDesign> BandPassDesignPtr;
+
+    /**
+     * @brief 不经缓存直接设计带通滤波器
+     *
+     * 供需要评估大量一次性候选设计的调用者使用（如 design_min_cost_bandpass），
+     * 避免候选设计挤占全局缓存。
+     *
+     * @throws std::invalid_argument 阶数超出 1 ~ FilterDesignCache::kMaxOrder
+     */
+    BandPassDesignPtr design_bandpass(const BandPassSpec &spec);
+
+    /**
+     * @brief 线程安全的滤波器设计缓存
+     *
+     * 以 (族, 阶数, 采样率, 中心频率, 带宽, 族参数) 为键缓存设计结果。
+     * 相同参数只做一次模拟原型设计、带通变换和增益归一化，
+     * 之后的滤波器只需按节拷贝系数 (O(节数)，无三角函数运算)。
+     */
+    class FilterDesignCache
+    {
+    public:
+        /// 设计时支持的最大阶数
+        static const int kMaxOrder = 8;
+
+        /**
+         * @brief 获取全局缓存实例
+         */
+        static FilterDesignCache &instance();
+
+        /**
+         * @brief 获取（必要时设计并缓存）带通滤波器
+         * @param low_freq 低频截止 (Hz)
+         * @param high_freq 高频截止 (Hz)
+         * @param sample_rate 采样率 (Hz)
+         * @param filter_order 滤波器阶数 (1 ~ kMaxOrder)
+         * @param family 滤波器族
+         * @return 共享的只读设计
+         */
+        BandPassDesignPtr get_bandpass(double low_freq, double high_freq,
+                                       double sample_rate, int filter_order,
+                                       FilterFamily family = FilterFamily::Butterworth);
+
+        /**
+         * @brief 按完整规格获取（必要时设计并缓存）带通滤波器
+         * @param spec 设计规格（族相关参数只对相应的族生效）
+         * @return 共享的只读设计
+         */
+        BandPassDesignPtr get_bandpass(const BandPassSpec &spec);
+
+        /**
+         * @brief 当前缓存的设计数
+         */
+        size_t size() const;
+
+        /**
+         * @brief 清空缓存（已取出的设计仍然有效）
+         */
+        void clear();
+
+    private:
+        typedef std::tuple<int, int, double, double, double, double, double, double> key_type;
+
+        FilterDesignCache() {}
+        FilterDesignCache(const FilterDesignCache &);
+        FilterDesignCache &operator=(const FilterDesignCache &);
+
+        mutable std::mutex mutex_;
+        std::map<key_type, BandPassDesignPtr> designs_;
+    };
+
+} // namespace ppg
+
+#endif // FILTER_DESIGN_CACHE_HPP
@@ -0,0 +1,83 @@
+#ifndef FILTER_DESIGN_SOLVER_HPP
+#define FILTER_DESIGN_SOLVER_HPP
+
+#include "filter_design_cache.hpp"
+
+namespace ppg
+{
+
+    /**
+     * @brief 带通滤波器的频域指标（通带/阻带边缘、纹波、衰减）
+     *
+     * 要求 0 < stop_low < pass_low < pass_high < stop_high < sample_rate / 2。
+     */
+    struct BandPassRequirements
+    {
+        double pass_low;            // 通带下边缘 (Hz)
+        double pass_high;           // 通带上边缘 (Hz)
+        double stop_low;            // 下阻带边缘 (Hz)，[0, stop_low] 为阻带
+        double stop_high;           // 上阻带边缘 (Hz)，[stop_high, fs/2] 为阻带
+        double sample_rate;         // 采样率 (Hz)
+        double passband_ripple_db;  // 通带内允许的最大起伏 (dB)
+        double stopband_atten_db;   // 阻带内要求的最小衰减 (dB，相对通带峰值)
+
+        BandPassRequirements(double pass_lo, double pass_hi, double stop_lo, double stop_hi,
+                             double fs, double ripple_db = 1.0, double atten_db = 40.0)
+            : pass_low(pass_lo), pass_high(pass_hi), stop_low(stop_lo), stop_high(stop_hi),
+              sample_rate(fs), passband_ripple_db(ripple_db), stopband_atten_db(atten_db)
+        {
+        }
+    };
+
+    /**
+     * @brief 最小代价设计的结果
+     */
+    struct BandPassSolution
+    {
+        BandPassSpec spec;              // 选中的设计规格，可直接传给 RealtimeFilter 等
+        BandPassDesignPtr design;       // 选中的设计（来自 FilterDesignCache）
+        int num_stages;                 // biquad 节数（代价）
+        double passband_ripple_db;      // 实测通带起伏 (dB)
+        double stopband_atten_db;       // 实测最小阻带衰减 (dB)
+        double group_delay_ms;          // 通带中心（算术平均）处的群延迟 (ms)
+        double cycles_per_sample;       // 估计每样本 CPU 周期数（单向）
+
+        explicit BandPassSolution(const BandPassSpec &s)
+            : spec(s), num_stages(0), passband_ripple_db(0.0), stopband_atten_db(0.0),
+              group_delay_ms(0.0), cycles_per_sample(0.0)
+        {
+        }
+    };
+
+    /// 每个 biquad 节每样本的估计周期数（DF-II：5 次乘法 + 4 次加法及状态读写）
+    const double kEstimatedCyclesPerStage = 6.0;
+
+    /**
+     * @brief 搜索满足指标且 biquad 节数最少的带通设计
+     *
+     * 依次尝试 1 ~ FilterDesignCache::kMaxOrder 节，在每个节数下遍历
+     * Butterworth、ChebyshevI、ChebyshevII、Elliptic 四个族：设计边缘在通带边缘
+     * 与阻带边缘之间扫描（各族对边缘的定义不同：-3dB 点、纹波边缘或阻带起点），
+     * Elliptic 另外扫描过渡带陡度。每个候选设计在通带和阻带的频率网格上用
+     * 各节频率响应之积（即 Cascade::response）检验，只有满足全部指标的才入选。
+     * 节数相同的候选取通带中心群延迟最小者，以降低实时路径的延迟。
+     *
+     * 候选设计不进入全局缓存，只有最终结果通过 FilterDesignCache 获取。
+     *
+     * @param req 频域指标
+     * @return 最小代价设计及其实测指标、群延迟与估计运算量
+     * @throws std::invalid_argument 指标非法，或 kMaxOrder 节以内无法满足
+     */
+    BandPassSolution design_min_cost_bandpass(const BandPassRequirements &req);
+
+    /**
+     * @brief 设计在给定频率处的群延迟
+     * @param design 带通设计
+     * @param frequency 频率 (Hz)
+     * @return 群延迟 (样本)
+     */
+    double group_delay_samples(const BandPassDesign &design, double frequency);
+
+} // namespace ppg
+
+#endif // FILTER_DESIGN_SOLVER_HPP
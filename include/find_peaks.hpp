@@ -38,16 +38,36 @@ struct PeakProperties {
  */
 std::vector<int> find_local_maxima(const std::vector<float>& signal);
 
+/**
+ * @brief 按优先级贪心选择彼此间距不小于distance的峰值
+ * 
+ * 对应scipy中的 _select_by_peak_distance(peaks, priority, distance)，
+ * 与 filter_peaks_by_distance 相同的贪心，但优先级由调用者给出，
+ * 不需要完整信号（流式检测中只保留了候选峰值的高度）。
+ * 
+ * @param peaks 峰值位置（升序）
+ * @param priority 各峰值的优先级（通常为高度），与peaks等长
+ * @param distance 最小间距
+ * @param keep 输出：keep[i] 非零表示保留第 i 个峰值
+ */
+void select_by_peak_distance(
+    const std::vector<int>& peaks,
+    const std::vector<float>& priority,
+    int distance,
+    std::vector<char>& keep
+);
+
 /**
  * @brief 根据distance约束过滤峰值
  * 
  * 对应scipy中的 _select_by_peak_distance(peaks, priority, distance)
  * 
  * 算法：
- * 1. 按优先级（峰值高度）排序
- * 2. 贪心选择：保留优先级高的峰值，删除距离太近的峰值
+ * 1. 按优先级（峰值高度，等高时位置靠右者优先）排序，O(P log P)
+ * 2. 贪心选择：保留优先级高的峰值，只检查位置上相邻、距离小于distance
+ *    的峰值并删除，扫描总量为O(P)
  * 
- * @param peaks 峰值索引
+ * @param peaks 峰值索引（按位置升序，find_local_maxima 的输出即是）
  * @param signal 原始信号
  * @param distance 最小间距
  * @return 过滤后的峰值索引
@@ -58,6 +78,26 @@ std::vector<int> filter_peaks_by_distance(
     int distance
 );
 
+/**
+ * @brief 一遍扫描同时找峰值和谷值，并对两者应用distance约束
+ * 
+ * 结果等价于 find_peaks(signal, distance) 与对取反信号的
+ * find_peaks(-signal, distance)，但不复制、不取反信号：局部最大值和
+ * 局部最小值在同一遍扫描中得到，两次贪心选择共用排序缓冲区。
+ * 输出写入调用者的数组（先清空，已有容量可复用）。
+ * 
+ * @param signal 输入信号
+ * @param distance 最小间距（样本数），不大于0表示不限制
+ * @param peaks 输出：峰值索引（升序）
+ * @param valleys 输出：谷值索引（升序）
+ */
+void find_peaks_and_valleys(
+    const std::vector<float>& signal,
+    int distance,
+    std::vector<int>& peaks,
+    std::vector<int>& valleys
+);
+
 /**
  * @brief 根据height约束过滤峰值
  * 
@@ -79,6 +119,8 @@ std::vector<int> filter_peaks_by_height(
  * 
  * Prominence定义：峰值相对于周围最低点的高度
  * 
+ * 单个峰值的逐点搜索版本，最坏 O(N)；一组峰值请用 calculate_prominences。
+ * 
  * @param signal 原始信号
  * @param peak_idx 峰值索引
  * @param left_base 左侧基线位置（输出）
@@ -92,18 +134,47 @@ float calculate_prominence(
     int& right_base
 );
 
+/**
+ * @brief 一次计算一组峰值的显著性与左右基线
+ * 
+ * 对应scipy中的 _peak_prominences(x, peaks, wlen)：从峰值向两侧搜索，
+ * 遇到严格高于峰值的样本或窗口边缘即停止，基线取搜索范围内离峰值最近的最低点。
+ * 
+ * 算法：单调栈求每个样本左/右侧第一个更高的样本，出栈时合并区间最小值，
+ * 得到不受窗口限制时的搜索结果；被窗口截断的峰值改用滑动窗口最小值。
+ * 总复杂度 O(N + P)，与单调段长度无关（逐点搜索在单调段上为 O(N·P)）。
+ * 
+ * @param signal 原始信号
+ * @param peaks 峰值索引（按位置升序）
+ * @param prominences 输出：显著性
+ * @param left_bases 输出：左侧基线位置
+ * @param right_bases 输出：右侧基线位置
+ * @param wlen 搜索窗口长度（样本），峰值位于窗口中央，偶数按下一个奇数处理；
+ *             小于2表示不限制（默认）
+ */
+void calculate_prominences(
+    const std::vector<float>& signal,
+    const std::vector<int>& peaks,
+    std::vector<float>& prominences,
+    std::vector<int>& left_bases,
+    std::vector<int>& right_bases,
+    int wlen = -1
+);
+
 /**
  * @brief 根据prominence约束过滤峰值
  * 
- * @param peaks 峰值索引
+ * @param peaks 峰值索引（按位置升序）
  * @param signal 原始信号
  * @param min_prominence 最小显著性（默认：0.0）
+ * @param wlen 显著性搜索窗口长度（默认：不限制），见 calculate_prominences
  * @return 过滤后的峰值索引
  */
 std::vector<int> filter_peaks_by_prominence(
     const std::vector<int>& peaks,
     const std::vector<float>& signal,
-    float min_prominence = 0.0f
+    float min_prominence = 0.0f,
+    int wlen = -1
 );
 
 /**
@@ -118,13 +189,17 @@ std::vector<int> filter_peaks_by_prominence(
  * @param distance 峰值最小间距（样本数，默认：0）
  * @param min_height 峰值最小高度（默认：无限制）
  * @param min_prominence 峰值最小显著性（默认：不使用，-1.0表示禁用）
+ * @param wlen 显著性搜索窗口长度（默认：不限制）
  * @return 峰值索引数组
+ * 
+ * 约束按scipy的顺序依次应用：height → distance → prominence。
  */
 std::vector<int> find_peaks(
     const std::vector<float>& signal,
     int distance = 0,
     float min_height = -std::numeric_limits<float>::infinity(),
-    float min_prominence = -1.0f
+    float min_prominence = -1.0f,
+    int wlen = -1
 );
 
 /**
@@ -136,6 +211,7 @@ std::vector<int> find_peaks(
  * @param distance 峰值最小间距（默认：0）
  * @param min_height 最小高度（默认：无限制）
  * @param min_prominence 最小显著性（默认：不使用）
+ * @param wlen 显著性搜索窗口长度（默认：不限制）
  */
 void find_peaks_with_properties(
     const std::vector<float>& signal,
@@ -143,7 +219,8 @@ void find_peaks_with_properties(
     PeakProperties& properties,
     int distance = 0,
     float min_height = -std::numeric_limits<float>::infinity(),
-    float min_prominence = -1.0f
+    float min_prominence = -1.0f,
+    int wlen = -1
 );
 
 #endif // FIND_PEAKS_HPP
@@ -0,0 +1,46 @@
+#ifndef PARALLEL_FILTER_HPP
+#define PARALLEL_FILTER_HPP
+
+#include "DspFilters/Dsp.h"
+#include <cstddef>
+
+namespace ppg {
+
+// ===================== 分块并行IIR滤波 =====================
+
+/** 并行滤波支持的最大级联节数 */
+const int kParallelMaxStages = 16;
+
+/** 每个线程至少分到的样本数，信号更短时退化为顺序滤波 */
+const size_t kParallelMinChunk = 16384;
+
+/**
+ * @brief 分块并行的级联IIR滤波（TDF-II状态），结果与顺序滤波数值等价
+ *
+ * 级联滤波器是线性时不变系统，块 k 的输出 = 零初值输出 + 块首状态 S_k 的零输入响应：
+ *   1. 各块以零初值并行滤波，记录块末状态 F_k；
+ *   2. 顺序递推真实块首状态 S_{k+1} = A^L · S_k + F_k
+ *      （A 为级联零输入状态转移矩阵，A^L 用快速幂求得，只需 O(log L) 次矩阵乘）；
+ *   3. 各块并行叠加由 S_k 出发的零输入响应，响应衰减到可忽略时提前结束。
+ * 总计算量约为顺序滤波的1倍多一点，因此随核数近似线性加速。
+ * 与顺序滤波的差异仅来自float的舍入：块内零初值输出先以float存储，其
+ * 阶跃瞬态可达输入直流的量级，叠加修正后的误差约为输入直流处的半个ulp
+ * （30000的直流偏置时约1e-3），而不是输出幅度处的ulp。
+ *
+ * @param cascade 级联系数（节数不超过 kParallelMaxStages）
+ * @param data 输入/输出数据（in-place修改）
+ * @param n 样本数
+ * @param state 长度为 2*节数 的TDF-II状态（与 Cascade::StateBase::getState 布局一致）：
+ *              输入为初始状态，返回时为结束状态；nullptr 表示零初值
+ * @param reverse true 时从末尾向开头滤波（filtfilt的反向滤波）
+ * @param num_threads 线程数，0 表示 std::thread::hardware_concurrency()
+ *
+ * @throws std::invalid_argument 节数超出范围
+ */
+void parallel_cascade_filter(const Dsp::Cascade& cascade, float* data, size_t n,
+                             double* state = nullptr, bool reverse = false,
+                             int num_threads = 0);
+
+} // namespace ppg
+
+#endif // PARALLEL_FILTER_HPP
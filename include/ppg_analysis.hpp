@@ -2,10 +2,52 @@
 #define PPG_ANALYSIS_HPP
 
 #include <vector>
+#include <cstddef>
 
 namespace ppg
 {
 
+    /**
+     * @brief 逐搏记录（结构数组，各数组等长，第 i 项对应第 i 个成功配对的峰值）
+     *
+     * 每个峰值与其前后最近的谷值配对，没有任何谷值的峰值不产生记录。
+     * 逐搏的幅度可直接用于逐搏SpO2；平均AC分量由 mean_amplitude() 导出。
+     */
+    struct BeatRecords
+    {
+        std::vector<int> peaks;          // 峰值索引
+        std::vector<int> valleys_before; // 峰值之前最近的谷值索引，没有时为-1
+        std::vector<int> valleys_after;  // 峰值之后最近的谷值索引，没有时为-1
+        std::vector<float> amplitudes;   // AC幅度：峰值减去两侧谷值的平均值（只有一侧时取该侧）
+        std::vector<int> rise_samples;   // 上升时间（样本数，前一个谷值到峰值；除以采样率即秒），没有前谷值时为-1
+
+        size_t size() const { return peaks.size(); }
+
+        void clear()
+        {
+            peaks.clear();
+            valleys_before.clear();
+            valleys_after.clear();
+            amplitudes.clear();
+            rise_samples.clear();
+        }
+
+        /// 平均AC分量（峰峰值），没有记录时为0
+        float mean_amplitude() const
+        {
+            if (amplitudes.empty())
+            {
+                return 0.0f;
+            }
+            float sum = 0.0f;
+            for (float amplitude : amplitudes)
+            {
+                sum += amplitude;
+            }
+            return sum / amplitudes.size();
+        }
+    };
+
     /**
      * @brief 检测PPG信号的峰值和谷值
      * @param filtered_signal 滤波后的信号
@@ -14,6 +56,7 @@ namespace ppg
      * @param peaks 输出：峰值索引数组
      * @param valleys 输出：谷值索引数组
      * @param ac_component 输出：平均AC分量
+     * @param beats 输出：逐搏记录（可为 nullptr）
      */
     void detect_peaks_and_valleys(
         const std::vector<float> &filtered_signal,
@@ -21,6 +64,42 @@ namespace ppg
         double min_time_interval,
         std::vector<int> &peaks,
         std::vector<int> &valleys,
+        float &ac_component,
+        BeatRecords *beats = nullptr);
+
+    /**
+     * @brief 峰值与前后最近的谷值配对，生成逐搏记录
+     *
+     * peaks 与 valleys 均按位置升序，双指针归并，O(P + V)。
+     *
+     * @param filtered_signal 滤波后的信号
+     * @param peaks 峰值索引数组（升序）
+     * @param valleys 谷值索引数组（升序）
+     * @param beats 输出：逐搏记录（先清空）
+     */
+    void pair_beats(
+        const std::vector<float> &filtered_signal,
+        const std::vector<int> &peaks,
+        const std::vector<int> &valleys,
+        BeatRecords &beats);
+
+    /**
+     * @brief 计算平均AC分量（峰峰值）
+     *
+     * 每个峰值与其前后最近的谷值配对，AC 取峰值减去两侧谷值的平均值
+     * （只有一侧谷值时取该侧），再对所有峰值求平均（即 pair_beats 的
+     * mean_amplitude()）。
+     *
+     * @param filtered_signal 滤波后的信号
+     * @param peaks 峰值索引数组（相对 filtered_signal，升序）
+     * @param valleys 谷值索引数组（相对 filtered_signal，升序）
+     * @param ac_component 输出：平均AC分量，无法配对时为0
+     * @return true表示至少有一个峰值配对成功
+     */
+    bool calculate_ac_component(
+        const std::vector<float> &filtered_signal,
+        const std::vector<int> &peaks,
+        const std::vector<int> &valleys,
         float &ac_component);
 
     /**
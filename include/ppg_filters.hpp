@@ -2,54 +2,179 @@
 #define PPG_FILTERS_HPP
 
 #include <vector>
+#include <string>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <stdexcept>
+#include "DspFilters/Dsp.h"
+#include "filter_design_cache.hpp"
+#include "parallel_filter.hpp"
 
 namespace ppg {
 
 // ===================== 零相位滤波核心函数 =====================
 
+/**
+ * @brief filtfilt 边界延拓方式（与 scipy.signal.filtfilt 的 padtype 一致）
+ */
+enum class PadType {
+    None,       // 不延拓
+    Odd,        // 奇对称延拓: 2*x[0] - x[k]（scipy 默认）
+    Even,       // 偶对称延拓: x[k]
+    Constant    // 常数延拓: x[0] / x[n-1]
+};
+
+/**
+ * @brief 整段记录滤波使用的内核
+ */
+enum class FilterKernel {
+    Cascade,    // 级联二阶节，级优先分块递推（Cascade::processBlock）
+    StateSpace  // 分块状态空间（Dsp::BlockStateSpace）：每块一次矩阵-向量乘，无逐样本递推
+};
+
+/** 未提供scratch时，栈上可容纳的最大padlen */
+const int kFiltfiltStackPad = 256;
+
+/**
+ * @brief filtfilt 的分块状态空间分支：对信号主体滤波一遍
+ * @param filter 滤波器对象（只读取其级联系数）
+ * @param state TDF-II级联状态，滤波前后与内核的扁平状态相互交接
+ * @param data 第一个要处理的样本
+ * @param numSamples 样本数量
+ * @param stride 样本间距，-1 时从 data 开始倒序滤波
+ *
+ * 内核的块矩阵（5节时约5KB）只在此函数的栈帧中构造，其他内核分支的
+ * filtfilt 不承担这部分栈空间；每遍重新构造的开销为数千次乘加，相对
+ * 信号主体可以忽略。
+ */
+template<typename FilterType, typename StateType>
+void filtfilt_state_space_pass(const FilterType& filter, StateType& state,
+                               float* data, int numSamples, int stride) {
+    Dsp::BlockStateSpace<FilterType::MaxStages> block_kernel(filter);
+    double chunk_state[2 * FilterType::MaxStages];
+    state.getState(chunk_state, filter);
+    block_kernel.process(numSamples, data, chunk_state, stride);
+    state.setState(chunk_state, filter);
+}
+
 /**
  * @brief 零相位滤波函数（实现Python的filtfilt功能）
- * @param filter 滤波器对象
+ * @param filter 滤波器对象（只读取其级联系数，不修改其内部状态）
  * @param data 输入/输出数据（in-place修改）
  * @param numSamples 样本数量
- * 
+ * @param padtype 边界延拓方式，默认奇对称延拓
+ * @param padlen 延拓长度，<0 时取 scipy 默认值 3*(2*级数+1)
+ * @param scratch 可选的调用方缓冲区（至少 padlen 个float），用于暂存尾部延拓段
+ * @param scratch_size scratch 的容量
+ * @param num_threads 信号主体的滤波线程数，1 为顺序滤波，0 为硬件并发数，
+ *                    其他值使用分块并行滤波（parallel_cascade_filter，结果数值等价）
+ * @param kernel 顺序滤波时信号主体使用的内核（num_threads 不为 1 时不使用），
+ *               两种内核结果数值等价
+ *
+ * 与 scipy 相同：两遍滤波都从稳态初始条件（lfilter_zi × 首样本）开始，
+ * 延拓段只参与滤波、不写回输出。反向滤波直接在原缓冲区上倒序迭代，
+ * 无需拷贝或反转；padlen 不超过 kFiltfiltStackPad 或提供了足够大的
+ * scratch 时，整个过程不分配堆内存。
+ *
+ * @throws std::invalid_argument 信号长度不大于 padlen
  * @note 模板函数必须在头文件中实现
  */
 template<typename FilterType>
-void filtfilt(FilterType& filter, float* data, int numSamples) {
-    std::cout << "执行零相位滤波 (filtfilt)..." << std::endl;
-    
-    float* temp = new float[numSamples];
-    float* temp_ptr = temp;  // 用于process函数的指针
-    
-    // 第一步：正向滤波
-    memcpy(temp, data, numSamples * sizeof(float));
-    filter.reset();
-    filter.process(numSamples, &temp_ptr);
-    std::cout << "  - 正向滤波完成" << std::endl;
-    
-    // 第二步：反转信号
-    std::reverse(temp, temp + numSamples);
-    std::cout << "  - 信号反转完成" << std::endl;
-    
-    // 第三步：反向滤波
-    temp_ptr = temp;  // 重置指针
-    filter.reset();
-    filter.process(numSamples, &temp_ptr);
-    std::cout << "  - 反向滤波完成" << std::endl;
-    
-    // 第四步：再次反转得到最终结果
-    std::reverse(temp, temp + numSamples);
-    std::cout << "  - 最终反转完成" << std::endl;
-    
-    // 复制结果到输出
-    memcpy(data, temp, numSamples * sizeof(float));
-    delete[] temp;
-    
-    std::cout << "零相位滤波完成！" << std::endl;
+void filtfilt(FilterType& filter, float* data, int numSamples,
+              PadType padtype = PadType::Odd, int padlen = -1,
+              float* scratch = nullptr, int scratch_size = 0,
+              int num_threads = 1, FilterKernel kernel = FilterKernel::Cascade) {
+    if (numSamples <= 0) {
+        return;
+    }
+    if (padtype == PadType::None) {
+        padlen = 0;
+    } else if (padlen < 0) {
+        padlen = 3 * (2 * filter.getNumStages() + 1);
+    }
+    if (padlen >= numSamples) {
+        throw std::invalid_argument("filtfilt: 信号长度必须大于padlen");
+    }
+
+    // 尾部延拓段：先存放延拓值，正向滤波后原地替换为正向输出，供反向滤波使用
+    float stack_pad[kFiltfiltStackPad];
+    std::vector<float> heap_pad;
+    float* tail = scratch;
+    if (tail == nullptr || scratch_size < padlen) {
+        if (padlen <= kFiltfiltStackPad) {
+            tail = stack_pad;
+        } else {
+            heap_pad.resize(padlen);
+            tail = heap_pad.data();
+        }
+    }
+
+    const float first = data[0];
+    const float last = data[numSamples - 1];
+
+    // 延拓值只依赖原始数据，必须在正向滤波覆盖data之前取出
+    for (int j = 0; j < padlen; j++) {
+        const float x = data[numSamples - 2 - j];
+        switch (padtype) {
+            case PadType::Odd:      tail[j] = 2.0f * last - x; break;
+            case PadType::Even:     tail[j] = x;               break;
+            default:                tail[j] = last;            break;
+        }
+    }
+
+    typename FilterType::template State<Dsp::TransposedDirectFormII> state;
+
+    // 状态空间内核与TDF-II状态使用相同的扁平状态布局，可直接交接
+    const bool use_state_space = (num_threads == 1 && kernel == FilterKernel::StateSpace);
+
+    // 第一遍：正向滤波（头部延拓段 -> 信号 -> 尾部延拓段）
+    float head_first = first;
+    if (padtype == PadType::Odd) {
+        head_first = 2.0f * first - data[padlen];
+    } else if (padtype == PadType::Even) {
+        head_first = data[padlen];
+    }
+    state.setSteadyState(head_first, filter);
+    for (int k = 0; k < padlen; k++) {
+        const float x = data[padlen - k];
+        float ext = first;
+        if (padtype == PadType::Odd) {
+            ext = 2.0f * first - x;
+        } else if (padtype == PadType::Even) {
+            ext = x;
+        }
+        state.process(ext, filter);
+    }
+    double chunk_state[2 * kParallelMaxStages];
+    if (use_state_space) {
+        filtfilt_state_space_pass(filter, state, data, numSamples, 1);
+    } else if (num_threads == 1) {
+        state.processBlock(numSamples, data, filter);
+    } else {
+        state.getState(chunk_state, filter);
+        parallel_cascade_filter(filter, data, numSamples, chunk_state, false, num_threads);
+        state.setState(chunk_state, filter);
+    }
+    if (padlen > 0) {
+        state.processBlock(padlen, tail, filter);
+    }
+
+    // 第二遍：反向滤波（从正向输出的最后一个样本开始倒序迭代）
+    state.reset();
+    state.setSteadyState(padlen > 0 ? tail[padlen - 1] : data[numSamples - 1], filter);
+    if (padlen > 0) {
+        // 尾部延拓段的反向输出不需要保留，原地覆盖即可
+        state.processBlock(padlen, tail + padlen - 1, filter, -1);
+    }
+    if (use_state_space) {
+        filtfilt_state_space_pass(filter, state, data + numSamples - 1, numSamples, -1);
+    } else if (num_threads == 1) {
+        state.processBlock(numSamples, data + numSamples - 1, filter, -1);
+    } else {
+        state.getState(chunk_state, filter);
+        parallel_cascade_filter(filter, data, numSamples, chunk_state, true, num_threads);
+    }
 }
 
 // ===================== 滤波函数声明 =====================
@@ -61,14 +186,35 @@ void filtfilt(FilterType& filter, float* data, int numSamples) {
  * @param high_freq 高频截止 (Hz)
  * @param sample_rate 采样率 (Hz)
  * @param filter_order 滤波器阶数
+ * @param num_threads 滤波线程数，1 为顺序滤波，0 为硬件并发数
+ * @param kernel 顺序滤波时使用的内核（级联递推 / 分块状态空间）
  * @return 滤波后的信号
+ * @throws std::invalid_argument 设计的节数超出范围
  */
 std::vector<float> apply_bandpass_zerophase(
     const std::vector<float>& input_signal,
     double low_freq,
     double high_freq,
     double sample_rate,
-    int filter_order = 3
+    int filter_order = 3,
+    int num_threads = 1,
+    FilterKernel kernel = FilterKernel::Cascade
+);
+
+/**
+ * @brief 零相位带通滤波（按设计规格，运行时选择滤波器族与阶数）
+ * @param input_signal 输入信号
+ * @param spec 设计规格（族、阶数、通带、族参数），节数不超过5
+ * @param num_threads 滤波线程数，1 为顺序滤波，0 为硬件并发数
+ * @param kernel 顺序滤波时使用的内核（级联递推 / 分块状态空间）
+ * @return 滤波后的信号
+ * @throws std::invalid_argument 设计的节数超出范围
+ */
+std::vector<float> apply_bandpass_zerophase(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec,
+    int num_threads = 1,
+    FilterKernel kernel = FilterKernel::Cascade
 );
 
 /**
@@ -79,7 +225,10 @@ std::vector<float> apply_bandpass_zerophase(
  * @param sample_rate 采样率 (Hz)
  * @param filter_order 滤波器阶数
  * @param use_warmup 是否使用均值初始化预热
+ * @param num_threads 滤波线程数，1 为顺序滤波，0 为硬件并发数
+ * @param kernel 顺序滤波时使用的内核（级联递推 / 分块状态空间）
  * @return 滤波后的信号
+ * @throws std::invalid_argument 设计的节数超出范围
  */
 std::vector<float> apply_bandpass_oneway(
     const std::vector<float>& input_signal,
@@ -87,7 +236,156 @@ std::vector<float> apply_bandpass_oneway(
     double high_freq,
     double sample_rate,
     int filter_order = 3,
-    bool use_warmup = true
+    bool use_warmup = true,
+    int num_threads = 1,
+    FilterKernel kernel = FilterKernel::Cascade
+);
+
+/**
+ * @brief 单向IIR带通滤波（按设计规格，运行时选择滤波器族与阶数）
+ * @param input_signal 输入信号
+ * @param spec 设计规格（族、阶数、通带、族参数），节数不超过5
+ * @param use_warmup 是否使用均值初始化预热
+ * @param num_threads 滤波线程数，1 为顺序滤波，0 为硬件并发数
+ * @param kernel 顺序滤波时使用的内核（级联递推 / 分块状态空间）
+ * @return 滤波后的信号
+ * @throws std::invalid_argument 设计的节数超出范围
+ */
+std::vector<float> apply_bandpass_oneway(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec,
+    bool use_warmup = true,
+    int num_threads = 1,
+    FilterKernel kernel = FilterKernel::Cascade
+);
+
+// ===================== 数值精度评估 =====================
+
+/**
+ * @brief 单精度滤波路径相对双精度路径的精度报告（每种状态结构一项）
+ */
+struct PrecisionReport {
+    std::string form;             // 状态结构名称（如 "DirectFormII<float>"）
+    double max_abs_error;         // 时域最大绝对误差
+    double rms_error;             // 时域均方根误差
+    double snr_db;                // 双精度输出能量 / 误差能量 (dB)
+    double passband_error_db;     // 系数量化导致的通带幅频响应最大偏差 (dB)
+};
+
+/**
+ * @brief 对比单精度（float系数+float状态）与双精度带通滤波的输出
+ *
+ * 双精度路径为当前使用的 DirectFormII<double>；单精度路径分别使用
+ * DirectFormII / TransposedDirectFormII / DirectFormI 的float版本。
+ * 通带偏差在 [low_freq, high_freq] 上按对数间隔取点计算。
+ *
+ * @param input_signal 输入信号
+ * @param low_freq 低频截止 (Hz)
+ * @param high_freq 高频截止 (Hz)
+ * @param sample_rate 采样率 (Hz)
+ * @param filter_order 滤波器阶数
+ * @return 每种单精度状态结构的精度报告
+ * @throws std::invalid_argument 设计的节数超出范围
+ */
+std::vector<PrecisionReport> compare_float_precision(
+    const std::vector<float>& input_signal,
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order = 3
+);
+
+/**
+ * @brief 对比单精度与双精度带通滤波的输出（按设计规格，系数来自设计缓存）
+ * @param input_signal 输入信号
+ * @param spec 设计规格（族、阶数、通带、族参数），节数不超过5
+ * @return 每种单精度状态结构的精度报告
+ * @throws std::invalid_argument 设计的节数超出范围
+ */
+std::vector<PrecisionReport> compare_float_precision(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec
+);
+
+// ===================== 滤波内核吞吐量评估 =====================
+
+/**
+ * @brief 单个滤波内核的吞吐量报告
+ */
+struct ThroughputReport {
+    std::string method;           // 内核名称（如 "TDF-II 逐样本"）
+    double ns_per_sample;         // 每样本耗时 (ns，取多次运行的最小值)
+    double speedup;               // 相对第一项（逐样本基线）的加速比
+    double max_abs_error;         // 相对基线输出的最大绝对误差
+};
+
+/**
+ * @brief 对同一带通设计比较不同滤波内核的吞吐量与一致性
+ *
+ * 基线为逐样本（sample-major）级联：每个样本依次经过所有节。
+ * 对比项为级优先（stage-major）分块处理（Cascade::processBlock）：
+ * 整块依次经过每一节，系数和状态在整块内常驻寄存器；以及并联二阶节
+ * （Dsp::ParallelForm，部分分式展开），各节并行计算后求和；以及分块状态
+ * 空间内核（Dsp::BlockStateSpace），每块一次矩阵-向量乘。
+ * 最大误差一项即各实现相对级联基线的精度。
+ *
+ * @param input_signal 输入信号（建议使用完整记录）
+ * @param low_freq 低频截止 (Hz)
+ * @param high_freq 高频截止 (Hz)
+ * @param sample_rate 采样率 (Hz)
+ * @param filter_order 滤波器阶数（节数不超过5）
+ * @param repetitions 每个内核的重复次数
+ * @return 每个内核的吞吐量报告，第一项为基线
+ * @throws std::invalid_argument 设计的节数超出范围
+ */
+std::vector<ThroughputReport> benchmark_filter_kernels(
+    const std::vector<float>& input_signal,
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order = 3,
+    int repetitions = 5
+);
+
+// ===================== 非规格化数浸泡测试 =====================
+
+/**
+ * @brief 一种非规格化数策略在长时间静默/平线输入下的表现
+ */
+struct DenormalSoakReport {
+    std::string policy;           // 策略名称（vsa注入 / FTZ-DAZ / 不处理）
+    std::string idle_kind;        // 空闲段类型（静默 / 平线）
+    double ns_per_sample_active;  // 有信号段每样本耗时 (ns)
+    double ns_per_sample_idle;    // 空闲段每样本耗时 (ns)
+    double slow_block_ratio;      // 空闲段块耗时99分位 / 有信号段块耗时中位数
+    int subnormal_states;         // 结束时落在非规格化范围内的状态数
+    bool realtime_policy;         // 是否为实时路径使用的策略（Dsp::DenormalRealtime）
+};
+
+/**
+ * @brief 非规格化数浸泡测试：传感器空闲或断开后滤波器是否出现CPU尖峰
+ *
+ * 输入为一段有信号的合成脉搏波，之后是很长的空闲段：全零（静默）或
+ * 恒定ADC值（平线）。带通滤波器的输出和各节状态在空闲段内指数衰减，
+ * 不加处理时会进入非规格化范围，x86上每次运算慢几十倍。
+ * 对 Dsp::DenormalInjection / DenormalFlushToZero / DenormalIgnore 三种
+ * 策略以及实时路径使用的 Dsp::DenormalRealtime 的DF-II级联按块计时，
+ * 并在结束时检查各节状态是否为非规格化数。tests/test_denormal_soak 对
+ * 实时策略的空闲段块耗时设有上限。
+ *
+ * @param low_freq 低频截止 (Hz)
+ * @param high_freq 高频截止 (Hz)
+ * @param sample_rate 采样率 (Hz)
+ * @param filter_order 滤波器阶数
+ * @param idle_seconds 空闲段时长 (秒)，需足够长才能衰减到非规格化范围
+ * @return 每种策略、每种空闲段的报告
+ */
+std::vector<DenormalSoakReport> benchmark_denormal_soak(
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order = 3,
+    double idle_seconds = 900.0
 );
 
 } // namespace ppg
@@ -2,8 +2,11 @@
 #define REALTIME_FILTER_HPP
 
 #include "DspFilters/Dsp.h"
+#include "cascade_kernel.hpp"
+#include "filter_design_cache.hpp"
 #include <vector>
 #include <deque>
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 
@@ -11,10 +14,19 @@ namespace ppg
 {
 
     /**
-     * @brief 实时IIR带通滤波器类（逐样本处理）
+     * @brief 浮点路径的滤波器实现结构
+     */
+    enum class FilterRealization
+    {
+        Cascade,    // 级联二阶节（默认）
+        Parallel    // 并联二阶节：部分分式展开 + 直通FIR项，各节相互独立
+    };
+
+    /**
+     * @brief 实时IIR带通滤波器类（逐样本/逐块处理）
      *
-     * 该类封装了Butterworth带通滤波器，支持逐样本输入和输出，
-     * 适合嵌入式实时系统使用。
+     * 该类封装了带通滤波器（默认Butterworth，可按 BandPassSpec 运行时选择族），
+     * 支持逐样本或按FIFO块输入和输出，适合嵌入式实时系统使用。
      */
     class RealtimeFilter
     {
@@ -25,9 +37,27 @@ namespace ppg
          * @param high_freq 高频截止频率 (Hz)
          * @param sample_rate 采样率 (Hz)
          * @param filter_order 滤波器阶数
+         * @param realization 浮点路径的实现结构。Parallel 把级联展开为并联
+         *        二阶节（Dsp::ParallelForm），各节互不等待，逐样本延迟链更短；
+         *        传递函数相同，输出与级联在舍入误差范围内一致
+         * @throws std::invalid_argument 设计的节数超出范围
          */
         RealtimeFilter(double low_freq, double high_freq,
-                       double sample_rate, int filter_order = 3);
+                       double sample_rate, int filter_order = 3,
+                       FilterRealization realization = FilterRealization::Cascade);
+
+        /**
+         * @brief 按设计规格构造（运行时选择滤波器族与阶数）
+         *
+         * 设计完成后只剩biquad系数，逐块处理由按节数展开的块内核完成
+         * （CascadeKernel，每块一次间接调用），与族无关；Elliptic /
+         * Chebyshev 等族用更少的节即可达到阻带要求，每样本开销随之下降。
+         *
+         * @param spec 设计规格（族、阶数、通带、族参数），节数不超过6
+         * @param realization 浮点路径的实现结构
+         */
+        explicit RealtimeFilter(const BandPassSpec &spec,
+                                FilterRealization realization = FilterRealization::Cascade);
 
         /**
          * @brief 处理单个样本
@@ -37,23 +67,299 @@ namespace ppg
         float process_sample(float input);
 
         /**
-         * @brief 重置滤波器状态
+         * @brief 处理一个样本块（对应传感器FIFO一次读出的数据）
+         *
+         * 整块数据一次性送入级联滤波器，避免逐样本调用的开销。
+         * in 与 out 可以指向同一缓冲区。
+         *
+         * @param in 输入样本数组
+         * @param out 输出样本数组（长度至少为n）
+         * @param n 样本数
+         */
+        void process_block(const float *in, float *out, size_t n);
+
+        /**
+         * @brief 原地处理一个样本块
+         * @param data 输入/输出样本数组
+         * @param n 样本数
+         */
+        void process_block(float *data, size_t n);
+
+        /**
+         * @brief 定点路径：直接处理16位整型样本块（Q15）
+         *
+         * 使用Q31系数、64位累加器和误差反馈的定点级联（Dsp::FixedPointCascade），
+         * 全程整数运算，结果与MCU固件逐位一致，省去 int→float→double→int 的
+         * 逐样本转换。定点路径的状态与浮点路径相互独立。
+         * in 与 out 可以指向同一缓冲区。
+         *
+         * @param in 输入样本数组（ADC原始值）
+         * @param out 输出样本数组（四舍五入并饱和到16位）
+         * @param n 样本数
+         */
+        void process_block(const int16_t *in, int16_t *out, size_t n);
+
+        /**
+         * @brief 重置滤波器状态（浮点与定点路径）
          */
         void reset();
 
         /**
-         * @brief 使用初始值预热滤波器（减少瞬态响应）
+         * @brief 直接设置为直流输入下的稳态（浮点与定点路径，O(节数)）
+         *
+         * 逐节求解 scipy lfilter_zi 式的稳态：相当于输入 dc_value 已持续
+         * 无限长时间，因此信号从 dc_value 附近开始时没有阶跃瞬态。
+         *
+         * @param dc_value 直流输入值（通常使用信号的均值）
+         */
+        void prime(float dc_value);
+
+        /**
+         * @brief 使用初始值预热滤波器（减少瞬态响应，浮点与定点路径）
+         *
+         * 等价于 prime(initial_value)；保留 num_samples 参数以兼容旧接口，
+         * 不再实际喂入样本（喂入有限个样本只能部分消除瞬态）。
+         *
          * @param initial_value 初始值（通常使用信号的均值）
-         * @param num_samples 预热样本数
+         * @param num_samples 预热样本数（已忽略）
          */
         void warmup(float initial_value, int num_samples = 100);
 
+        /**
+         * @brief 在线调整通带（无毛刺重调谐）
+         *
+         * 只设计一次新系数，随后 transition_samples 个样本内在格型（反射系数）
+         * 域逐样本插值新旧系数（Dsp::CascadeTransition），中间滤波器始终稳定，
+         * 每样本开销远低于逐样本重新设计。过渡进行中再次调用时，从当前插值
+         * 位置开始新的过渡。定点路径与并联实现不插值，立即切换到新系数。
+         *
+         * 各节的直流增益随系数变化，原始ADC信号的大直流偏置流经插值中的级联
+         * 会产生远大于信号本身的瞬态。过渡期间级联只处理减去直流参考（重调谐
+         * 时最近的输入样本）后的信号，直流参考乘以在新旧设计的直流增益之间
+         * 线性插值的增益后加回输出；状态在过渡开始和结束时按参考值的稳态换算。
+         *
+         * @param low_freq 新的低频截止频率 (Hz)
+         * @param high_freq 新的高频截止频率 (Hz)
+         * @param transition_samples 过渡样本数（0表示立即切换）
+         */
+        void retune(double low_freq, double high_freq, int transition_samples);
+
+        /**
+         * @brief 当前过渡剩余的样本数（0表示没有进行中的过渡）
+         */
+        int transition_remaining() const { return transition_.getRemainingSamples(); }
+
+        /**
+         * @brief 浮点路径当前使用的实现结构
+         */
+        FilterRealization realization() const { return realization_; }
+
+        /**
+         * @brief 当前的设计规格（retune 后为新的通带）
+         */
+        const BandPassSpec &spec() const { return spec_; }
+
     private:
-        Dsp::SimpleFilter<Dsp::Butterworth::BandPass<6>, 1> filter_;
-        double low_freq_;
-        double high_freq_;
+        typedef Dsp::Butterworth::BandPass<6> design_type;
+
+        /// 过渡中处理一个样本（去掉直流参考后经插值级联，再加回直流分量）
+        float transition_sample(float input);
+
+        /// 过渡结束：把通用级联状态交还给展开内核
+        void finish_transition();
+
+        /// state_ 加上当前系数下直流输入 dc_value 的稳态（状态对输入是线性的）
+        void add_steady_state(double dc_value);
+
+        design_type filter_;
+        design_type::State<Dsp::DirectFormII> state_;
+        Dsp::CascadeTransition<6> transition_;                // 重调谐过渡（过渡期间使用state_）
+        CascadeKernel kernel_;                                // 按节数展开的块内核（过渡期间不使用）
+        Dsp::FixedPointCascade<6> q15_kernel_;                // 定点（Q31系数）内核
+        Dsp::FixedPointCascade<6>::State q15_state_;
+        FilterRealization realization_;
+        Dsp::ParallelForm<6> parallel_;                       // 并联实现（realization_ == Parallel）
+        Dsp::ParallelForm<6>::State parallel_state_;
+        BandPassSpec spec_;
+        float last_input_;                                    // 浮点路径最近的输入样本
+        double transition_dc_;                                // 过渡期间从输入中减去的直流参考
+        double transition_dc_gain_;                           // 直流参考当前的增益
+        double transition_dc_gain_step_;                      // 直流增益每样本的增量
+    };
+
+    /**
+     * @brief 多通道实时带通滤波器（红光/红外光/绿光共用一组系数）
+     *
+     * 各通道的滤波器系数完全相同，因此把每个通道的biquad状态放在同一
+     * 状态对象的不同lane中（Dsp::LanesDirectFormII），一次级联遍历即可
+     * 同时滤波全部通道，向量化后多通道的开销约等于单通道。
+     */
+    class MultiChannelRealtimeFilter
+    {
+    public:
+        /// 最大通道数（lane数）
+        static const int kMaxChannels = 4;
+
+        /**
+         * @brief 构造函数
+         * @param num_channels 通道数 (1 ~ kMaxChannels)
+         * @param low_freq 低频截止频率 (Hz)
+         * @param high_freq 高频截止频率 (Hz)
+         * @param sample_rate 采样率 (Hz)
+         * @param filter_order 滤波器阶数
+         * @throws std::invalid_argument 通道数或设计的节数超出范围
+         */
+        MultiChannelRealtimeFilter(int num_channels,
+                                   double low_freq, double high_freq,
+                                   double sample_rate, int filter_order = 3);
+
+        /**
+         * @brief 按设计规格构造（运行时选择滤波器族与阶数）
+         * @param num_channels 通道数 (1 ~ kMaxChannels)
+         * @param spec 设计规格，节数不超过6
+         */
+        MultiChannelRealtimeFilter(int num_channels, const BandPassSpec &spec);
+
+        /**
+         * @brief 获取通道数
+         */
+        int num_channels() const { return num_channels_; }
+
+        /**
+         * @brief 处理一帧（每个通道一个样本）
+         * @param in 输入帧（num_channels个样本）
+         * @param out 输出帧（可与in相同）
+         *
+         * 非规格化数按 Dsp::DenormalRealtime 处理，每帧设置并恢复一次 FTZ/DAZ；
+         * 连续逐帧调用时可在循环外持有 Dsp::DenormalRealtime::Scope。
+         */
+        void process_frame(const float *in, float *out);
+
+        /**
+         * @brief 原地处理一个多通道样本块
+         * @param channels 通道指针数组，channels[c]指向第c通道的n个样本
+         * @param n 每个通道的样本数
+         */
+        void process_block(float *const *channels, size_t n);
+
+        /**
+         * @brief 重置所有通道的滤波器状态
+         */
+        void reset();
+
+        /**
+         * @brief 将各通道直接设置为直流输入下的稳态（O(节数)）
+         * @param dc_values 每个通道的直流输入值（通常为信号均值）
+         */
+        void prime(const float *dc_values);
+
+        /**
+         * @brief 使用各通道初始值预热滤波器（等价于 prime，num_samples 已忽略）
+         * @param initial_values 每个通道的初始值（通常为信号均值）
+         * @param num_samples 预热样本数（已忽略）
+         */
+        void warmup(const float *initial_values, int num_samples = 100);
+
+    private:
+        typedef Dsp::Butterworth::BandPass<6> design_type;
+        typedef Dsp::LanesDirectFormII<kMaxChannels, double> lanes_state_type;
+
+        design_type design_;
+        design_type::State<lanes_state_type, Dsp::DenormalRealtime> state_;
+        int num_channels_;
+    };
+
+    /**
+     * @brief 固定延迟的流式近似零相位带通滤波器
+     *
+     * 正向滤波逐样本连续进行；每累积 block_size 个正向输出，就从最新样本
+     * 开始对最近 lookahead + block_size 个正向输出做一次反向滤波：前
+     * lookahead 个输出仅用于让反向滤波器收敛（丢弃），其后 block_size 个
+     * 即为相位校正后的结果。输出相对输入的延迟固定为 latency_samples()。
+     *
+     * 结果是离线filtfilt的近似而不是等价：最新样本之后的正向输出未知，
+     * 反向滤波只能从猜测的状态出发，差异随lookahead指数衰减，衰减速度由
+     * 最低截止频率的极点决定。0.5-20Hz、3阶、1000Hz、PPG类输入时，误差
+     * （均方根，相对离线filtfilt输出的均方根）约为：
+     *
+     *   lookahead   250 ms   500 ms（默认）   1 s    2 s
+     *   误差        20-28%   6-9%             5%     1-1.6%
+     *
+     * 可保证的上限（tests/test_streaming_zero_phase）：默认前瞻下误差不超过12%，
+     * 前瞻2 s时不超过2%。默认前瞻只适合定位峰谷；依赖波形细节（如重搏切迹）
+     * 的分析应显式传入更长的前瞻（如2 s），代价是相应更长的延迟。
+     * 更低的低频截止需要成比例更长的前瞻。
+     */
+    class StreamingZeroPhaseFilter
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param low_freq 低频截止频率 (Hz)
+         * @param high_freq 高频截止频率 (Hz)
+         * @param sample_rate 采样率 (Hz)
+         * @param filter_order 滤波器阶数
+         * @param lookahead_seconds 反向滤波的前瞻长度（秒），决定误差与延迟，见类说明
+         * @param block_size 每次反向滤波输出的样本数，0表示取前瞻长度的1/4
+         * @throws std::invalid_argument 前瞻长度不为正，或设计的节数超出范围
+         */
+        StreamingZeroPhaseFilter(double low_freq, double high_freq,
+                                 double sample_rate, int filter_order = 3,
+                                 double lookahead_seconds = 0.5,
+                                 size_t block_size = 0);
+
+        /**
+         * @brief 处理单个样本
+         * @param input 输入样本值
+         * @return latency_samples() 个样本之前那个输入的零相位滤波结果
+         */
+        float process_sample(float input);
+
+        /**
+         * @brief 处理一个样本块（in 与 out 可以指向同一缓冲区）
+         * @param in 输入样本数组
+         * @param out 输出样本数组（每个输出相对对应输入延迟latency_samples()）
+         * @param n 样本数
+         */
+        void process_block(const float *in, float *out, size_t n);
+
+        /**
+         * @brief 输出相对输入的固定延迟（样本数）
+         */
+        size_t latency_samples() const { return lookahead_ + block_size_ - 1; }
+
+        /**
+         * @brief 输出相对输入的固定延迟（秒）
+         */
+        double latency_seconds() const { return latency_samples() / sample_rate_; }
+
+        /**
+         * @brief 重置滤波器，下一个输入样本将作为稳态初值
+         */
+        void reset();
+
+    private:
+        typedef Dsp::Butterworth::BandPass<6> design_type;
+        typedef design_type::State<Dsp::TransposedDirectFormII> state_type;
+
+        /// 以输入值x建立稳态（视为之前一直输入x）
+        void prime(float x);
+
+        /// 对最近 lookahead_ + block_size_ 个正向输出做反向滤波，结果写入output_
+        void run_backward_block();
+
+        design_type design_;
+        state_type forward_state_;
+        state_type backward_state_;
+        std::vector<float> history_;   // 正向输出的环形缓冲区（lookahead_ + block_size_）
+        std::vector<float> output_;    // 当前块的零相位输出（block_size_）
+        size_t head_;                  // history_ 中下一个写入位置
+        size_t pending_;               // 自上次反向滤波以来的新样本数
+        size_t output_pos_;            // output_ 中下一个输出位置
+        size_t lookahead_;
+        size_t block_size_;
         double sample_rate_;
-        int filter_order_;
+        bool primed_;
     };
 
     /**
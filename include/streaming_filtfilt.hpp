@@ -0,0 +1,48 @@
+#ifndef STREAMING_FILTFILT_HPP
+#define STREAMING_FILTFILT_HPP
+
+#include <cstddef>
+#include <string>
+#include "filter_design_cache.hpp"
+
+namespace ppg {
+
+/** 默认分块样本数（256KB的float缓冲区） */
+const size_t kStreamingChunkSamples = 65536;
+
+/**
+ * @brief 内存占用固定的文件到文件零相位带通滤波（超出内存的长记录）
+ *
+ * 与 apply_bandpass_zerophase 的输出逐位一致（保存格式与
+ * save_signal_to_file 相同），但内存占用只有一个分块缓冲区，与记录长度无关：
+ *
+ * 1. 正向：按块读取文本输入，滤波状态在块间延续，正向输出以二进制float
+ *    落盘到溢出文件 (output_path + ".spill")，同时只保留最后 padlen+1 个
+ *    原始样本用于尾部延拓；
+ * 2. 反向：从溢出文件末尾按块倒序读回，反向滤波后原地写回；
+ * 3. 最后顺序读出溢出文件写成文本输出，并删除溢出文件。
+ *
+ * 分块大小向上取整为 Dsp::Cascade::BlockTileSize 的整数倍，正向块从记录开头、
+ * 反向块从记录末尾对齐，因此分块边界与内存版本的分块递推完全重合。
+ * 磁盘上需要额外 4 字节/样本的临时空间。
+ *
+ * @param input_path 输入文本文件（每行一个样本，与 read_signal_from_file 相同）
+ * @param output_path 输出文本文件
+ * @param spec 设计规格，节数不超过5
+ * @param chunk_samples 每块样本数
+ * @param precision 输出小数精度
+ * @return 处理的样本数，文件无法打开时为0
+ * @throws std::invalid_argument 设计节数超出范围，或信号长度不大于padlen
+ * @throws std::runtime_error 溢出文件读写失败
+ */
+size_t apply_bandpass_zerophase_file(
+    const std::string& input_path,
+    const std::string& output_path,
+    const BandPassSpec& spec,
+    size_t chunk_samples = kStreamingChunkSamples,
+    int precision = 6
+);
+
+} // namespace ppg
+
+#endif // STREAMING_FILTFILT_HPP
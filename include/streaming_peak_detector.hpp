@@ -0,0 +1,225 @@
+#ifndef STREAMING_PEAK_DETECTOR_HPP
+#define STREAMING_PEAK_DETECTOR_HPP
+
+#include <vector>
+#include <deque>
+#include <limits>
+#include <cstddef>
+
+namespace ppg
+{
+
+    /**
+     * @brief 已确认的峰值或谷值
+     */
+    struct ConfirmedExtremum
+    {
+        size_t position; // 自 reset() 起的样本序号
+        float value;     // 该位置的信号值（谷值为原信号值，不取反）
+    };
+
+    /**
+     * @brief 增量式峰值/谷值检测器（逐样本或逐块输入）
+     *
+     * 与批量 find_peaks(signal, distance, min_height, min_prominence, wlen)
+     * 使用相同的定义（局部最大值 → height → distance → prominence），谷值等价于
+     * 对取反信号做同样的检测。状态全部增量维护，不保存历史窗口：
+     *
+     * - distance：候选峰值在位置上分段，遇到“间隙”（其后 distance 以内没有候选）
+     *   或“支配峰”（distance 以内没有更高优先级的候选）时，段内的贪心结果与全局
+     *   贪心一致，整段调用 select_by_peak_distance 一次确定；
+     * - prominence：左侧用单调栈合并区间最小值（wlen 时改用滑动窗口最小值），
+     *   右侧对仍在搜索的候选维护单调栈，遇到更高样本、窗口边缘，或右侧最小值已
+     *   足够低（显著性只会增大）时即确定。
+     *
+     * 每个样本均摊 O(1)：单调栈与队列中每个元素只进出一次，段内排序的长度受
+     * max_delay 约束。
+     *
+     * 确认延迟有界：峰值最晚在其后第 max_delay 个样本到达时确定。通常 distance
+     * 个样本后即确定；若到期仍未确定（例如间距都小于distance的单调上升峰值链，
+     * 或不带 wlen 的显著性迟迟不够），则按已有数据强制判定，计入
+     * forced_decisions()。forced_decisions() 为0时，输入全部样本并 flush() 后的
+     * 输出与对整段信号调用批量 find_peaks 的结果完全一致。
+     *
+     * 用法：
+     * @code
+     *   ppg::StreamingPeakDetector detector(40);
+     *   detector.process_block(samples, n);
+     *   std::vector<ppg::ConfirmedExtremum> peaks;
+     *   detector.take_peaks(peaks);
+     * @endcode
+     */
+    class StreamingPeakDetector
+    {
+    public:
+        /**
+         * @brief 构造函数（参数含义与 find_peaks 相同）
+         * @param distance 峰值最小间距（样本数）
+         * @param min_height 峰值最小高度（默认：无限制；谷值作用于取反信号）
+         * @param min_prominence 最小显著性（默认：-1.0，禁用）
+         * @param wlen 显著性搜索窗口长度（默认：不限制）
+         * @param max_delay 最大确认延迟（样本数），不大于0时取
+         *        4 * max(distance, wlen, 1)
+         * @throws std::invalid_argument max_delay 小于 distance
+         */
+        explicit StreamingPeakDetector(
+            int distance,
+            float min_height = -std::numeric_limits<float>::infinity(),
+            float min_prominence = -1.0f,
+            int wlen = -1,
+            int max_delay = -1);
+
+        /**
+         * @brief 输入单个样本
+         */
+        void process_sample(float input);
+
+        /**
+         * @brief 输入一个样本块
+         */
+        void process_block(const float *in, size_t n);
+
+        /**
+         * @brief 信号结束：按批量检测的边界规则确定所有未决的候选
+         *
+         * 之后需 reset() 才能继续输入。
+         */
+        void flush();
+
+        /**
+         * @brief 清空全部状态，样本序号从0重新开始
+         */
+        void reset();
+
+        /**
+         * @brief 取走已确认的峰值（按位置升序追加到 out）
+         * @return 追加的个数
+         */
+        size_t take_peaks(std::vector<ConfirmedExtremum> &out);
+
+        /**
+         * @brief 取走已确认的谷值（按位置升序追加到 out）
+         * @return 追加的个数
+         */
+        size_t take_valleys(std::vector<ConfirmedExtremum> &out);
+
+        /// 已输入的样本数
+        size_t samples_processed() const { return received_; }
+
+        /// 最大确认延迟（样本数）
+        int max_delay() const { return max_delay_; }
+
+        /// 因超过 max_delay 而强制判定的次数（峰值与谷值之和）
+        size_t forced_decisions() const;
+
+    private:
+        /**
+         * @brief 单一极性的检测状态（谷值使用取反后的样本）
+         */
+        class Tracker
+        {
+        public:
+            Tracker(float sign, int distance, float min_height, float min_prominence,
+                    int wlen, int max_delay);
+
+            /// 处理样本 x（序号 i）；is_local_max 由调用者根据前后样本判定
+            void step(size_t i, float x, bool is_local_max);
+            void finish();
+            void reset();
+            size_t take(std::vector<ConfirmedExtremum> &out);
+            size_t forced() const { return forced_; }
+
+        private:
+            enum DistanceState
+            {
+                Undecided,
+                Kept,
+                Removed
+            };
+            enum ProminenceState
+            {
+                Pending,
+                Passed,
+                Failed
+            };
+
+            struct Candidate
+            {
+                size_t position;
+                float height; // 取符号后的样本值
+                DistanceState distance_state;
+                ProminenceState prominence_state;
+            };
+
+            struct Sample
+            {
+                size_t position;
+                float value;
+            };
+
+            // 左侧搜索：样本值严格递减的单调栈，min_value 为到下一项之前的区间最小值
+            struct LeftEntry
+            {
+                size_t position;
+                float value;
+                float min_value;
+            };
+
+            // 右侧搜索中的候选：高度自底向上不增，segment_min 为其后到上一项之间的最小值
+            struct RightEntry
+            {
+                size_t position;
+                float height;
+                float left_min;
+                float segment_min;
+                size_t sequence;
+            };
+
+            // 距离约束的滑动窗口最大值队列（优先级递减）
+            struct DominanceEntry
+            {
+                size_t position;
+                float height;
+                bool left_dominant; // 入队时左侧 distance 以内没有更高优先级的候选
+            };
+
+            Candidate *find(size_t sequence);
+            void decide_prominence(const RightEntry &entry, float right_min);
+            void close_segment();
+            void emit(size_t i, bool at_end);
+
+            float sign_;
+            int distance_;
+            float min_height_;
+            float min_prominence_;
+            size_t half_window_; // 0 表示不限制
+            int max_delay_;
+
+            std::deque<Candidate> candidates_; // 尚未输出的候选（位置升序）
+            size_t front_sequence_;            // candidates_.front() 的序号
+            size_t undecided_sequence_;        // 第一个距离未决候选的序号
+            std::deque<Sample> window_;        // 最近 half_window+1 个样本的滑动最小值
+            std::deque<LeftEntry> left_;
+            std::deque<RightEntry> right_;
+            std::deque<DominanceEntry> dominance_;
+            bool has_kept_;
+            size_t last_kept_;
+            size_t forced_;
+
+            std::vector<int> segment_positions_;
+            std::vector<float> segment_heights_;
+            std::vector<char> segment_keep_;
+            std::vector<ConfirmedExtremum> confirmed_;
+        };
+
+        int max_delay_;
+        Tracker peaks_;
+        Tracker valleys_;
+        size_t received_;
+        float previous_;
+        float current_;
+    };
+
+} // namespace ppg
+
+#endif // STREAMING_PEAK_DETECTOR_HPP
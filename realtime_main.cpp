@@ -5,20 +5,46 @@
 #include <chrono>
 #include <thread>
 #include <cmath>
+#include <memory>
 #include "include/realtime_filter.hpp"
+#include "include/decimator.hpp"
 #include "include/ppg_analysis.hpp"
+#include "include/streaming_peak_detector.hpp"
 
 /**
  * @brief 实时PPG信号处理系统 - 双通道版本
  *
  * 模拟嵌入式设备实时系统环境：
- * - 从文件逐样本读取双通道数据（红光+红外光）
+ * - 从文件按传感器FIFO块读取双通道数据（红光+红外光）
  * - 使用单向IIR滤波器实时处理
+ * - 滤波后抽取到分析采样率（默认100Hz）再做分析
+ * - 增量检测峰值/谷值，每个样本只处理一次
  * - 维护滑动窗口进行分析
  * - 定期计算心率和SpO2
  * - 使用int16缓冲区优化内存使用
  */
 
+/**
+ * @brief 丢弃已滑出分析窗口的极值，返回窗口内的索引（相对窗口起点）
+ */
+static std::vector<int> window_indices(std::vector<ppg::ConfirmedExtremum> &extrema, size_t window_start)
+{
+    size_t first = 0;
+    while (first < extrema.size() && extrema[first].position < window_start)
+    {
+        first++;
+    }
+    extrema.erase(extrema.begin(), extrema.begin() + first);
+
+    std::vector<int> indices;
+    indices.reserve(extrema.size());
+    for (const ppg::ConfirmedExtremum &extremum : extrema)
+    {
+        indices.push_back(static_cast<int>(extremum.position - window_start));
+    }
+    return indices;
+}
+
 int main()
 {
     try
@@ -32,11 +58,19 @@ int main()
         const double LOW_FREQ = 0.5;      // 低频截止
         const double HIGH_FREQ = 20.0;    // 高频截止
         const int FILTER_ORDER = 3;       // 滤波器阶数
-
-        // 缓冲区配置（模拟嵌入式系统的内存限制）
-        const size_t ANALYSIS_WINDOW = 2100;                // 分析窗口：2.1秒
-        const size_t BUFFER_SIZE = ANALYSIS_WINDOW + 200;   // 2.3秒的数据
+        const std::string FILTER_FAMILY = "butterworth"; // 滤波器族（butterworth/chebyshev1/chebyshev2/elliptic/bessel/legendre）
+        // 定点滤波：true 时按MCU固件的Q15定点算术滤波（RealtimeFilter 的 int16 路径，
+        // 与固件逐位一致），用于核对固件输出；默认浮点路径在抽取前保留小数精度，
+        // 且双通道在一次lane并行中完成
+        const bool USE_FIXED_POINT = false;
+        const double ANALYSIS_RATE = 100.0; // 分析采样率（滤波后抽取，需整除SAMPLE_RATE）
+        const double MIN_PEAK_INTERVAL = 0.4; // 最小峰值间隔（秒）
+
+        // 缓冲区配置（模拟嵌入式系统的内存限制，单位为分析采样率下的样本数）
+        const size_t ANALYSIS_WINDOW = static_cast<size_t>(2.1 * ANALYSIS_RATE);               // 分析窗口：2.1秒
+        const size_t BUFFER_SIZE = ANALYSIS_WINDOW + static_cast<size_t>(0.2 * ANALYSIS_RATE); // 2.3秒的数据
         const size_t UPDATE_INTERVAL = ANALYSIS_WINDOW / 2; // 每1.05秒更新一次分析
+        const size_t FIFO_BLOCK_SIZE = 32;                  // 传感器FIFO每次读出的样本数
 
         // 是否实时模拟（添加延迟）
         const bool SIMULATE_REALTIME = true;   // true: 按实际采样率添加延迟
@@ -52,14 +86,20 @@ int main()
         std::cout << "  红光数据: " << red_file << std::endl;
         std::cout << "  红外光数据: " << ir_file << std::endl;
         std::cout << "  采样率: " << SAMPLE_RATE << " Hz" << std::endl;
-        std::cout << "  滤波器: Butterworth 带通 (" << LOW_FREQ << "-" << HIGH_FREQ << " Hz)" << std::endl;
+        ppg::BandPassSpec filter_spec(LOW_FREQ, HIGH_FREQ, SAMPLE_RATE, FILTER_ORDER,
+                                      ppg::parse_filter_family(FILTER_FAMILY));
+        std::cout << "  滤波器: " << ppg::filter_family_name(filter_spec.family)
+                  << " 带通 (" << LOW_FREQ << "-" << HIGH_FREQ << " Hz)" << std::endl;
         std::cout << "  滤波器阶数: " << FILTER_ORDER << std::endl;
+        std::cout << "  滤波算术: " << (USE_FIXED_POINT ? "Q15定点 (与固件逐位一致)" : "浮点") << std::endl;
+        std::cout << "  分析采样率: " << ANALYSIS_RATE << " Hz" << std::endl;
         std::cout << "  数据缓冲区: " << BUFFER_SIZE << " 样本 ("
-                  << BUFFER_SIZE / SAMPLE_RATE << " 秒)" << std::endl;
+                  << BUFFER_SIZE / ANALYSIS_RATE << " 秒)" << std::endl;
         std::cout << "  分析窗口: " << ANALYSIS_WINDOW << " 样本 ("
-                  << ANALYSIS_WINDOW / SAMPLE_RATE << " 秒)" << std::endl;
+                  << ANALYSIS_WINDOW / ANALYSIS_RATE << " 秒)" << std::endl;
         std::cout << "  更新间隔: " << UPDATE_INTERVAL << " 样本 ("
-                  << UPDATE_INTERVAL / SAMPLE_RATE << " 秒)" << std::endl;
+                  << UPDATE_INTERVAL / ANALYSIS_RATE << " 秒)" << std::endl;
+        std::cout << "  FIFO块大小: " << FIFO_BLOCK_SIZE << " 样本" << std::endl;
         std::cout << "  实时模拟: " << (SIMULATE_REALTIME ? "启用" : "禁用") << std::endl;
         std::cout << "  内存模式: 16位整型 (节省内存)" << std::endl;
         std::cout << std::string(70, '-') << std::endl;
@@ -67,12 +107,28 @@ int main()
         // ==================== 初始化组件 ====================
         std::cout << "\n【初始化系统组件】" << std::endl;
 
-        // 1. 创建双通道实时滤波器
-        ppg::RealtimeFilter filter_red(LOW_FREQ, HIGH_FREQ, SAMPLE_RATE, FILTER_ORDER);
-        ppg::RealtimeFilter filter_ir(LOW_FREQ, HIGH_FREQ, SAMPLE_RATE, FILTER_ORDER);
+        // 1. 创建双通道实时滤波器（红光与红外光共用系数，lane并行滤波）
+        const int CHANNEL_RED = 0;
+        const int CHANNEL_IR = 1;
+        ppg::MultiChannelRealtimeFilter filter(2, filter_spec);
+        // 定点模式下每个通道各用一个 RealtimeFilter 的Q15定点路径
+        std::unique_ptr<ppg::RealtimeFilter> fixed_filter_red;
+        std::unique_ptr<ppg::RealtimeFilter> fixed_filter_ir;
+        if (USE_FIXED_POINT)
+        {
+            fixed_filter_red.reset(new ppg::RealtimeFilter(filter_spec));
+            fixed_filter_ir.reset(new ppg::RealtimeFilter(filter_spec));
+        }
         std::cout << "  ✓ 双通道滤波器创建完成 (红光 + 红外光)" << std::endl;
 
-        // 2. 创建双通道数据缓冲区 (int16)
+        // 2. 创建抽取器（滤波信号与原始信号各一组，原始信号用于DC估计）
+        ppg::Decimator decimator_red(SAMPLE_RATE, ANALYSIS_RATE, HIGH_FREQ);
+        ppg::Decimator decimator_ir(SAMPLE_RATE, ANALYSIS_RATE, HIGH_FREQ);
+        ppg::Decimator raw_decimator_red(SAMPLE_RATE, ANALYSIS_RATE, HIGH_FREQ);
+        ppg::Decimator raw_decimator_ir(SAMPLE_RATE, ANALYSIS_RATE, HIGH_FREQ);
+        std::cout << "  ✓ 抽取器创建完成 (" << SAMPLE_RATE << " Hz -> " << ANALYSIS_RATE << " Hz)" << std::endl;
+
+        // 3. 创建双通道数据缓冲区 (int16)
         ppg::RealtimeBufferInt16 raw_buffer_red(BUFFER_SIZE);      // 红光原始信号
         ppg::RealtimeBufferInt16 raw_buffer_ir(BUFFER_SIZE);       // 红外光原始信号
         ppg::RealtimeBufferInt16 filtered_buffer_red(BUFFER_SIZE); // 红光滤波信号
@@ -81,7 +137,16 @@ int main()
         std::cout << "  ✓ 双通道数据缓冲区创建完成 (16位整型: "
                   << (BUFFER_SIZE * 4 * 2) / 1024.0 << "KB)" << std::endl;
 
-        // 3. 打开双通道数据文件
+        // 4. 创建增量峰值检测器（峰值在其后 distance 个样本内确认，无需重复扫描窗口）
+        const int PEAK_DISTANCE = static_cast<int>(ANALYSIS_RATE * MIN_PEAK_INTERVAL);
+        ppg::StreamingPeakDetector peak_detector_red(PEAK_DISTANCE);
+        ppg::StreamingPeakDetector peak_detector_ir(PEAK_DISTANCE);
+        std::vector<ppg::ConfirmedExtremum> confirmed_peaks_red, confirmed_valleys_red;
+        std::vector<ppg::ConfirmedExtremum> confirmed_peaks_ir, confirmed_valleys_ir;
+        std::cout << "  ✓ 增量峰值检测器创建完成 (最小间距: " << PEAK_DISTANCE
+                  << " 样本, 最大确认延迟: " << peak_detector_red.max_delay() << " 样本)" << std::endl;
+
+        // 5. 打开双通道数据文件
         std::ifstream red_stream(red_file);
         std::ifstream ir_stream(ir_file);
         if (!red_stream.is_open())
@@ -96,7 +161,7 @@ int main()
         }
         std::cout << "  ✓ 双通道数据文件打开成功" << std::endl;
 
-        // 4. 预读取一些样本用于滤波器预热
+        // 6. 预读取一些样本用于滤波器预热
         std::cout << "\n【滤波器预热】" << std::endl;
         std::vector<float> warmup_samples_red, warmup_samples_ir;
         std::string line_red, line_ir;
@@ -131,8 +196,17 @@ int main()
 
         float initial_mean_red = warmup_sum_red / warmup_samples_red.size();
         float initial_mean_ir = warmup_sum_ir / warmup_samples_ir.size();
-        filter_red.warmup(initial_mean_red, 100);
-        filter_ir.warmup(initial_mean_ir, 100);
+        float initial_means[2];
+        initial_means[CHANNEL_RED] = initial_mean_red;
+        initial_means[CHANNEL_IR] = initial_mean_ir;
+        filter.prime(initial_means);
+        if (USE_FIXED_POINT)
+        {
+            fixed_filter_red->prime(initial_mean_red);
+            fixed_filter_ir->prime(initial_mean_ir);
+        }
+        raw_decimator_red.warmup(initial_mean_red);
+        raw_decimator_ir.warmup(initial_mean_ir);
         std::cout << "  ✓ 双通道滤波器预热完成 (红光均值: " << initial_mean_red 
                   << ", 红外光均值: " << initial_mean_ir << ")" << std::endl;
 
@@ -148,163 +222,220 @@ int main()
         std::cout << "开始实时数据处理..." << std::endl;
         std::cout << std::string(70, '=') << std::endl;
 
-        size_t sample_count = 0;
+        size_t sample_count = 0;          // 原始采样率下的样本数
+        size_t analysis_sample_count = 0; // 分析采样率下的样本数
         size_t last_analysis_count = 0;
         int analysis_count = 0;
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
-        // 逐样本读取并处理双通道数据
-        while (std::getline(red_stream, line_red) && std::getline(ir_stream, line_ir))
+        // 按传感器FIFO块读取并处理双通道数据
+        std::vector<int16_t> block_raw_red, block_raw_ir;
+        std::vector<float> block_red, block_ir;
+        std::vector<int16_t> block_fixed_red, block_fixed_ir;
+        std::vector<float> block_raw_float_red, block_raw_float_ir;
+        std::vector<float> dec_red(FIFO_BLOCK_SIZE + 1), dec_ir(FIFO_BLOCK_SIZE + 1);
+        std::vector<float> dec_raw_red(FIFO_BLOCK_SIZE + 1), dec_raw_ir(FIFO_BLOCK_SIZE + 1);
+        block_raw_red.reserve(FIFO_BLOCK_SIZE);
+        block_raw_ir.reserve(FIFO_BLOCK_SIZE);
+        bool stream_ended = false;
+
+        while (!stream_ended)
         {
-            int16_t raw_sample_red, raw_sample_ir;
-            try
+            // 读取一个FIFO块
+            block_raw_red.clear();
+            block_raw_ir.clear();
+            while (block_raw_red.size() < FIFO_BLOCK_SIZE)
             {
-                raw_sample_red = static_cast<int16_t>(std::stoi(line_red));
-                raw_sample_ir = static_cast<int16_t>(std::stoi(line_ir));
+                if (!std::getline(red_stream, line_red) || !std::getline(ir_stream, line_ir))
+                {
+                    stream_ended = true;
+                    break;
+                }
+
+                int16_t raw_sample_red, raw_sample_ir;
+                try
+                {
+                    raw_sample_red = static_cast<int16_t>(std::stoi(line_red));
+                    raw_sample_ir = static_cast<int16_t>(std::stoi(line_ir));
+                }
+                catch (...)
+                {
+                    continue; // 跳过无效数据
+                }
+                block_raw_red.push_back(raw_sample_red);
+                block_raw_ir.push_back(raw_sample_ir);
             }
-            catch (...)
+
+            if (block_raw_red.empty())
             {
-                continue; // 跳过无效数据
+                break;
             }
 
-            // 步骤1: 双通道实时滤波
-            float raw_red_float = static_cast<float>(raw_sample_red);
-            float raw_ir_float = static_cast<float>(raw_sample_ir);
-            
-            float filtered_red_float = filter_red.process_sample(raw_red_float);
-            float filtered_ir_float = filter_ir.process_sample(raw_ir_float);
-
-            // 四舍五入转换为整型（损失小数精度但节省内存）
-            int16_t filtered_red_int = static_cast<int16_t>(std::round(filtered_red_float));
-            int16_t filtered_ir_int = static_cast<int16_t>(std::round(filtered_ir_float));
-
-            // 步骤2: 添加到双通道缓冲区
-            raw_buffer_red.push(raw_sample_red);
-            raw_buffer_ir.push(raw_sample_ir);
-            filtered_buffer_red.push(filtered_red_int);
-            filtered_buffer_ir.push(filtered_ir_int);
-
-            sample_count++;
-
-            // 步骤3: 定期进行信号分析
-            if (sample_count >= ANALYSIS_WINDOW &&
-                (sample_count - last_analysis_count) >= UPDATE_INTERVAL)
+            // 步骤1: 双通道块滤波
+            block_raw_float_red.assign(block_raw_red.begin(), block_raw_red.end());
+            block_raw_float_ir.assign(block_raw_ir.begin(), block_raw_ir.end());
+            if (USE_FIXED_POINT)
+            {
+                // 定点路径：ADC样本以int16直接滤波，无 int→float 转换
+                block_fixed_red.resize(block_raw_red.size());
+                block_fixed_ir.resize(block_raw_ir.size());
+                fixed_filter_red->process_block(block_raw_red.data(), block_fixed_red.data(), block_raw_red.size());
+                fixed_filter_ir->process_block(block_raw_ir.data(), block_fixed_ir.data(), block_raw_ir.size());
+                block_red.assign(block_fixed_red.begin(), block_fixed_red.end());
+                block_ir.assign(block_fixed_ir.begin(), block_fixed_ir.end());
+            }
+            else
             {
+                block_red.assign(block_raw_red.begin(), block_raw_red.end());
+                block_ir.assign(block_raw_ir.begin(), block_raw_ir.end());
+                float *block_channels[2];
+                block_channels[CHANNEL_RED] = block_red.data();
+                block_channels[CHANNEL_IR] = block_ir.data();
+                filter.process_block(block_channels, block_red.size());
+            }
 
-                analysis_count++;
-                last_analysis_count = sample_count;
+            // 步骤2: 抽取到分析采样率（四路抽取器相位一致，输出个数相同）
+            size_t num_decimated = decimator_red.process_block(block_red.data(), block_red.size(), dec_red.data());
+            decimator_ir.process_block(block_ir.data(), block_ir.size(), dec_ir.data());
+            raw_decimator_red.process_block(block_raw_float_red.data(), block_raw_float_red.size(), dec_raw_red.data());
+            raw_decimator_ir.process_block(block_raw_float_ir.data(), block_raw_float_ir.size(), dec_raw_ir.data());
 
-                // 获取双通道分析窗口数据
-                size_t start_idx = 0;
-                if (filtered_buffer_red.size() > ANALYSIS_WINDOW)
-                {
-                    start_idx = filtered_buffer_red.size() - ANALYSIS_WINDOW;
-                }
+            size_t previous_sample_count = sample_count;
+            sample_count += block_raw_red.size();
 
-                // 直接获取指定范围的浮点数据，减少内存拷贝
-                std::vector<float> filtered_data_red = filtered_buffer_red.get_data_float(
-                    start_idx, ANALYSIS_WINDOW);
-                std::vector<float> raw_data_red = raw_buffer_red.get_data_float(
-                    start_idx, ANALYSIS_WINDOW);
-                std::vector<float> filtered_data_ir = filtered_buffer_ir.get_data_float(
-                    start_idx, ANALYSIS_WINDOW);
-                std::vector<float> raw_data_ir = raw_buffer_ir.get_data_float(
-                    start_idx, ANALYSIS_WINDOW);
-
-                // 峰值检测和AC分量计算 - 红光通道
-                std::vector<int> red_peaks, red_valleys;
-                float red_ac_component = 0.0f;
-                ppg::detect_peaks_and_valleys(
-                    filtered_data_red,
-                    SAMPLE_RATE,
-                    0.4, // 最小峰值间隔0.4秒
-                    red_peaks,
-                    red_valleys,
-                    red_ac_component);
-
-                // 峰值检测和AC分量计算 - 红外光通道
-                std::vector<int> ir_peaks, ir_valleys;
-                float ir_ac_component = 0.0f;
-                ppg::detect_peaks_and_valleys(
-                    filtered_data_ir,
-                    SAMPLE_RATE,
-                    0.4,
-                    ir_peaks,
-                    ir_valleys,
-                    ir_ac_component);
-
-                // 心率计算（使用红光通道的峰值）
-                float heart_rate = 0.0f;
-                float hrv = 0.0f;
-                bool hr_valid = ppg::calculate_heart_rate(
-                    red_peaks,
-                    SAMPLE_RATE,
-                    heart_rate,
-                    hrv);
-
-                // SpO2计算（使用双通道数据）
-                float spo2 = 0.0f;
-                float ratio = 0.0f;
-                bool spo2_valid = ppg::calculate_spo2_dual_channel(
-                    raw_data_red,
-                    filtered_data_red,
-                    red_ac_component,
-                    raw_data_ir,
-                    filtered_data_ir,
-                    ir_ac_component,
-                    spo2,
-                    ratio);
-
-                // 输出结果
-                auto current_time = std::chrono::high_resolution_clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                   current_time - start_time)
-                                   .count();
-
-                std::cout << "\n[分析 #" << analysis_count << "] ";
-                std::cout << "样本: " << sample_count << " | ";
-                std::cout << "时间: " << elapsed / 1000.0 << "s | ";
-                std::cout << "缓冲区: " << filtered_buffer_red.size() << "/" << BUFFER_SIZE << std::endl;
-
-                std::cout << "  峰值数(红光): " << red_peaks.size() << " (红外光): " << ir_peaks.size() << " | ";
-                std::cout << "谷值数(红光): " << red_valleys.size() << " (红外光): " << ir_valleys.size() << std::endl;
-                std::cout << "  AC(红光): " << red_ac_component << " | AC(红外光): " << ir_ac_component << std::endl;
-
-                if (hr_valid)
-                {
-                    std::cout << "  ❤️  心率: " << heart_rate << " BPM | ";
-                    std::cout << "HRV: " << hrv << " ms" << std::endl;
-                }
-                else
+            for (size_t i = 0; i < num_decimated; ++i)
+            {
+                // 四舍五入转换为整型（损失小数精度但节省内存）
+                int16_t filtered_red_int = static_cast<int16_t>(std::round(dec_red[i]));
+                int16_t filtered_ir_int = static_cast<int16_t>(std::round(dec_ir[i]));
+
+                // 步骤3: 添加到双通道缓冲区
+                raw_buffer_red.push(static_cast<int16_t>(std::round(dec_raw_red[i])));
+                raw_buffer_ir.push(static_cast<int16_t>(std::round(dec_raw_ir[i])));
+                filtered_buffer_red.push(filtered_red_int);
+                filtered_buffer_ir.push(filtered_ir_int);
+
+                // 步骤4: 增量峰值检测（输入与缓冲区中相同的整型值）
+                peak_detector_red.process_sample(filtered_red_int);
+                peak_detector_ir.process_sample(filtered_ir_int);
+                peak_detector_red.take_peaks(confirmed_peaks_red);
+                peak_detector_red.take_valleys(confirmed_valleys_red);
+                peak_detector_ir.take_peaks(confirmed_peaks_ir);
+                peak_detector_ir.take_valleys(confirmed_valleys_ir);
+
+                analysis_sample_count++;
+
+                // 步骤5: 定期进行信号分析
+                if (analysis_sample_count >= ANALYSIS_WINDOW &&
+                    (analysis_sample_count - last_analysis_count) >= UPDATE_INTERVAL)
                 {
-                    std::cout << "  ❤️  心率: 无效 (峰值不足)" << std::endl;
-                }
 
-                if (spo2_valid)
-                {
-                    std::cout << "  🫁 SpO2: " << spo2 << " % | ";
-                    std::cout << "R: " << ratio << std::endl;
+                    analysis_count++;
+                    last_analysis_count = analysis_sample_count;
+
+                    // 获取双通道分析窗口数据
+                    size_t start_idx = 0;
+                    if (filtered_buffer_red.size() > ANALYSIS_WINDOW)
+                    {
+                        start_idx = filtered_buffer_red.size() - ANALYSIS_WINDOW;
+                    }
+
+                    // 直接获取指定范围的浮点数据，减少内存拷贝
+                    std::vector<float> filtered_data_red = filtered_buffer_red.get_data_float(
+                        start_idx, ANALYSIS_WINDOW);
+                    std::vector<float> raw_data_red = raw_buffer_red.get_data_float(
+                        start_idx, ANALYSIS_WINDOW);
+                    std::vector<float> filtered_data_ir = filtered_buffer_ir.get_data_float(
+                        start_idx, ANALYSIS_WINDOW);
+                    std::vector<float> raw_data_ir = raw_buffer_ir.get_data_float(
+                        start_idx, ANALYSIS_WINDOW);
+
+                    // 窗口内已确认的峰值和谷值（窗口起点为分析采样率下的绝对序号）
+                    const size_t window_start = analysis_sample_count - ANALYSIS_WINDOW;
+                    std::vector<int> red_peaks = window_indices(confirmed_peaks_red, window_start);
+                    std::vector<int> red_valleys = window_indices(confirmed_valleys_red, window_start);
+                    std::vector<int> ir_peaks = window_indices(confirmed_peaks_ir, window_start);
+                    std::vector<int> ir_valleys = window_indices(confirmed_valleys_ir, window_start);
+
+                    // AC分量计算
+                    float red_ac_component = 0.0f;
+                    float ir_ac_component = 0.0f;
+                    ppg::calculate_ac_component(filtered_data_red, red_peaks, red_valleys, red_ac_component);
+                    ppg::calculate_ac_component(filtered_data_ir, ir_peaks, ir_valleys, ir_ac_component);
+
+                    // 心率计算（使用红光通道的峰值）
+                    float heart_rate = 0.0f;
+                    float hrv = 0.0f;
+                    bool hr_valid = ppg::calculate_heart_rate(
+                        red_peaks,
+                        ANALYSIS_RATE,
+                        heart_rate,
+                        hrv);
+
+                    // SpO2计算（使用双通道数据）
+                    float spo2 = 0.0f;
+                    float ratio = 0.0f;
+                    bool spo2_valid = ppg::calculate_spo2_dual_channel(
+                        raw_data_red,
+                        filtered_data_red,
+                        red_ac_component,
+                        raw_data_ir,
+                        filtered_data_ir,
+                        ir_ac_component,
+                        spo2,
+                        ratio);
+
+                    // 输出结果
+                    auto current_time = std::chrono::high_resolution_clock::now();
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       current_time - start_time)
+                                       .count();
+
+                    std::cout << "\n[分析 #" << analysis_count << "] ";
+                    std::cout << "样本: " << previous_sample_count + (i + 1) * decimator_red.factor() << " | ";
+                    std::cout << "时间: " << elapsed / 1000.0 << "s | ";
+                    std::cout << "缓冲区: " << filtered_buffer_red.size() << "/" << BUFFER_SIZE << std::endl;
+
+                    std::cout << "  峰值数(红光): " << red_peaks.size() << " (红外光): " << ir_peaks.size() << " | ";
+                    std::cout << "谷值数(红光): " << red_valleys.size() << " (红外光): " << ir_valleys.size() << std::endl;
+                    std::cout << "  AC(红光): " << red_ac_component << " | AC(红外光): " << ir_ac_component << std::endl;
+
+                    if (hr_valid)
+                    {
+                        std::cout << "  ❤️  心率: " << heart_rate << " BPM | ";
+                        std::cout << "HRV: " << hrv << " ms" << std::endl;
+                    }
+                    else
+                    {
+                        std::cout << "  ❤️  心率: 无效 (峰值不足)" << std::endl;
+                    }
+
+                    if (spo2_valid)
+                    {
+                        std::cout << "  🫁 SpO2: " << spo2 << " % | ";
+                        std::cout << "R: " << ratio << std::endl;
+                    }
+                    else
+                    {
+                        std::cout << "  🫁 SpO2: 无效 (信号质量不足)" << std::endl;
+                    }
+
+                    std::cout << std::string(70, '-') << std::endl;
                 }
-                else
-                {
-                    std::cout << "  🫁 SpO2: 无效 (信号质量不足)" << std::endl;
-                }
-
-                std::cout << std::string(70, '-') << std::endl;
             }
 
-            // 模拟实时延迟（可选）
-            if (SIMULATE_REALTIME && sample_count % 10 == 0)
+            // 定期显示进度（每5000个原始样本）
+            if (sample_count / 5000 != previous_sample_count / 5000)
             {
-                std::this_thread::sleep_for(
-                    std::chrono::microseconds(static_cast<int>(SAMPLE_INTERVAL_MS * 1000 * 10)));
+                std::cout << "处理进度: " << (sample_count / 5000) * 5000 << " 样本..." << std::endl;
             }
 
-            // 定期显示进度（每5000个样本）
-            if (sample_count % 5000 == 0)
+            // 模拟实时延迟（可选）：等待一个FIFO块的采样时间
+            if (SIMULATE_REALTIME)
             {
-                std::cout << "处理进度: " << sample_count << " 样本..." << std::endl;
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(static_cast<int>(SAMPLE_INTERVAL_MS * 1000 * block_raw_red.size())));
             }
         }
 
@@ -328,6 +459,7 @@ int main()
         std::cout << "  处理速度: " << (sample_count / (total_duration / 1000.0)) << " 样本/秒" << std::endl;
         std::cout << "  实时因子: " << (sample_count / SAMPLE_RATE) / (total_duration / 1000.0) << "x" << std::endl;
         std::cout << "  分析次数: " << analysis_count << std::endl;
+        std::cout << "  峰值强制确认次数: " << peak_detector_red.forced_decisions() + peak_detector_ir.forced_decisions() << std::endl;
         std::cout << std::string(70, '=') << std::endl;
     }
     catch (const std::exception &e)
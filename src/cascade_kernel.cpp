@@ -0,0 +1,139 @@
+#include "include/cascade_kernel.hpp"
+#include <stdexcept>
+
+namespace ppg
+{
+
+    const int CascadeKernel::kMaxStages;
+    const int CascadeKernel::kCoefficientsPerStage;
+
+    namespace
+    {
+        // 节数为编译期常量的块内核，各节由模板递归展开
+        // 注入量由策略给出，FTZ/DAZ 策略下恒为0，编译后不占用逐样本运算
+        template <int Stages>
+        void process_fixed(const double *coeffs, double *state,
+                           CascadeKernel::denormal_policy &denormal, float *data, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                data[i] = static_cast<float>(Dsp::FixedCascadeSections<0, Stages, double>::process(
+                    data[i], coeffs, state, denormal.ac()));
+            }
+        }
+
+        typedef void (*BlockFunction)(const double *, double *, CascadeKernel::denormal_policy &,
+                                      float *, size_t);
+
+        // 下标为节数
+        const BlockFunction kBlockFunctions[] = {
+            &process_fixed<0>, &process_fixed<1>, &process_fixed<2>,
+            &process_fixed<3>, &process_fixed<4>, &process_fixed<5>,
+            &process_fixed<6>, &process_fixed<7>, &process_fixed<8>,
+        };
+        static_assert(sizeof(kBlockFunctions) / sizeof(kBlockFunctions[0]) ==
+                          CascadeKernel::kMaxStages + 1,
+                      "每个节数都需要一个块内核");
+    } // namespace
+
+    CascadeKernel::CascadeKernel()
+        : block_function_(&process_fixed<0>), num_stages_(0)
+    {
+        reset();
+    }
+
+    void CascadeKernel::setup(const Dsp::Cascade &cascade)
+    {
+        const int stages = cascade.getNumStages();
+        if (stages < 0 || stages > kMaxStages)
+        {
+            throw std::invalid_argument("CascadeKernel: 节数超出范围");
+        }
+
+        num_stages_ = stages;
+        block_function_ = kBlockFunctions[stages];
+        for (int i = 0; i < stages; i++)
+        {
+            const Dsp::Cascade::Stage &s = cascade[i];
+            double *k = coeffs_ + kCoefficientsPerStage * i;
+            k[0] = s.m_b0;
+            k[1] = s.m_b1;
+            k[2] = s.m_b2;
+            k[3] = s.m_a1;
+            k[4] = s.m_a2;
+        }
+        reset();
+    }
+
+    void CascadeKernel::setup(const BandPassDesign &design)
+    {
+        if (design.num_stages() > kMaxStages)
+        {
+            throw std::invalid_argument("CascadeKernel: 节数超出范围");
+        }
+        Dsp::Butterworth::BandPass<kMaxStages> cascade;
+        cascade.setStages(design.stages.data(), design.num_stages());
+        setup(cascade);
+    }
+
+    float CascadeKernel::process_sample(float input)
+    {
+        denormal_policy::Scope scope;
+        double x = input + denormal_.ac();
+        const double *k = coeffs_;
+        double *v = state_;
+        for (int i = 0; i < num_stages_; i++, k += kCoefficientsPerStage, v += 2)
+        {
+            const double w = x - k[3] * v[0] - k[4] * v[1];
+            x = k[0] * w + k[1] * v[0] + k[2] * v[1];
+            v[1] = v[0];
+            v[0] = w;
+        }
+        return static_cast<float>(x);
+    }
+
+    void CascadeKernel::process_block(float *data, size_t n)
+    {
+        denormal_policy::Scope scope;
+        block_function_(coeffs_, state_, denormal_, data, n);
+    }
+
+    void CascadeKernel::reset()
+    {
+        for (int i = 0; i < 2 * kMaxStages; i++)
+        {
+            state_[i] = 0.0;
+        }
+    }
+
+    double CascadeKernel::prime(double dc_value)
+    {
+        double x = dc_value;
+        for (int i = 0; i < num_stages_; i++)
+        {
+            const double *k = coeffs_ + kCoefficientsPerStage * i;
+            const double den = 1.0 + k[3] + k[4];
+            const double w = (den != 0.0) ? x / den : 0.0;
+            state_[2 * i] = state_[2 * i + 1] = w;
+            x = (k[0] + k[1] + k[2]) * w;
+        }
+        return x;
+    }
+
+    void CascadeKernel::get_state(double *dest) const
+    {
+        for (int i = 0; i < 2 * num_stages_; i++)
+        {
+            dest[i] = state_[i];
+        }
+    }
+
+    void CascadeKernel::set_state(const double *src)
+    {
+        for (int i = 0; i < 2 * num_stages_; i++)
+        {
+            state_[i] = src[i];
+        }
+    }
+
+} // namespace ppg
@@ -0,0 +1,122 @@
+#include "include/decimator.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace ppg
+{
+
+    // ==================== Decimator 实现 ====================
+
+    Decimator::Decimator(double input_rate, double output_rate, double passband_hz)
+        : pos_(0), phase_(0), factor_(0), input_rate_(input_rate), output_rate_(output_rate)
+    {
+        if (input_rate <= 0.0 || output_rate <= 0.0 || output_rate > input_rate)
+        {
+            throw std::invalid_argument("Decimator: 采样率无效");
+        }
+
+        double ratio = input_rate / output_rate;
+        factor_ = static_cast<int>(std::lround(ratio));
+        if (std::fabs(ratio - factor_) > 1e-9)
+        {
+            throw std::invalid_argument("Decimator: 输出采样率必须整除输入采样率");
+        }
+        if (passband_hz <= 0.0 || passband_hz >= output_rate / 2.0)
+        {
+            throw std::invalid_argument("Decimator: 通带必须小于输出采样率的一半");
+        }
+
+        // Hamming窗长度由过渡带宽决定：N ≈ 3.3 * fs / Δf，取奇数保证线性相位的整数延迟
+        double transition = output_rate - 2.0 * passband_hz;
+        int num_taps = static_cast<int>(std::ceil(3.3 * input_rate / transition));
+        num_taps |= 1;
+        if (factor_ == 1)
+        {
+            num_taps = 1;
+        }
+
+        // 窗函数法设计低通，截止频率 output_rate/2，直流增益归一化为1
+        double cutoff = 0.5 * output_rate / input_rate;
+        double center = (num_taps - 1) / 2.0;
+        std::vector<double> h(num_taps);
+        double sum = 0.0;
+        for (int k = 0; k < num_taps; ++k)
+        {
+            double t = k - center;
+            double sinc = (t == 0.0) ? 2.0 * cutoff
+                                     : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+            double window = (num_taps > 1)
+                                ? 0.54 - 0.46 * std::cos(2.0 * M_PI * k / (num_taps - 1))
+                                : 1.0;
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+
+        taps_.resize(num_taps);
+        for (int k = 0; k < num_taps; ++k)
+        {
+            taps_[num_taps - 1 - k] = static_cast<float>(h[k] / sum);
+        }
+        history_.assign(2 * taps_.size(), 0.0f);
+
+        std::cout << "抽取器初始化:" << std::endl;
+        std::cout << "  - 采样率: " << input_rate_ << " Hz -> " << output_rate_ << " Hz (抽取倍数 "
+                  << factor_ << ")" << std::endl;
+        std::cout << "  - 抗混叠FIR: " << taps_.size() << " 抽头, 群延迟 "
+                  << delay_seconds() * 1000.0 << " ms" << std::endl;
+    }
+
+    bool Decimator::process_sample(float input, float &output)
+    {
+        // 写入双倍延迟线的两个位置，使 history_[pos_+1 .. pos_+N] 始终是最近N个样本
+        const size_t num_taps = taps_.size();
+        pos_ = (pos_ + 1) % num_taps;
+        history_[pos_] = input;
+        history_[pos_ + num_taps] = input;
+
+        if (phase_ > 0)
+        {
+            --phase_;
+            return false;
+        }
+        phase_ = factor_ - 1;
+
+        const float *x = &history_[pos_ + 1];
+        float acc = 0.0f;
+        for (size_t k = 0; k < num_taps; ++k)
+        {
+            acc += taps_[k] * x[k];
+        }
+        output = acc;
+        return true;
+    }
+
+    size_t Decimator::process_block(const float *in, size_t n, float *out)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (process_sample(in[i], out[count]))
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    void Decimator::warmup(float value)
+    {
+        std::fill(history_.begin(), history_.end(), value);
+        phase_ = 0;
+    }
+
+    void Decimator::reset()
+    {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        pos_ = 0;
+        phase_ = 0;
+    }
+
+} // namespace ppg
@@ -0,0 +1,99 @@
+#include "filter_chain.hpp"
+#include <stdexcept>
+
+namespace ppg
+{
+
+    const int FusedFilterChain::kMaxStages;
+
+    FusedFilterChain::FusedFilterChain(double sample_rate)
+        : sample_rate_(sample_rate), tap_mask_(0), num_taps_(0)
+    {
+        if (sample_rate <= 0.0)
+        {
+            throw std::invalid_argument("FusedFilterChain: 采样率必须为正");
+        }
+    }
+
+    void FusedFilterChain::check_room(int stages) const
+    {
+        if (num_stages() + stages > kMaxStages)
+        {
+            throw std::invalid_argument("FusedFilterChain: 节数超过上限");
+        }
+    }
+
+    FusedFilterChain &FusedFilterChain::add_bandpass(const BandPassSpec &spec)
+    {
+        if (spec.sample_rate != sample_rate_)
+        {
+            throw std::invalid_argument("FusedFilterChain: 带通设计的采样率与链不一致");
+        }
+        BandPassDesignPtr design = FilterDesignCache::instance().get_bandpass(spec);
+        check_room(design->num_stages());
+
+        for (int i = 0; i < design->num_stages(); i++)
+        {
+            chain_.append(design->stages[i]);
+        }
+        reset();
+        return *this;
+    }
+
+    FusedFilterChain &FusedFilterChain::add_notch(double frequency, double q)
+    {
+        if (frequency <= 0.0 || frequency >= 0.5 * sample_rate_ || q <= 0.0)
+        {
+            throw std::invalid_argument("FusedFilterChain: 陷波频率或Q值非法");
+        }
+        check_room(1);
+
+        // RBJ带阻的第三个参数实为Q值
+        Dsp::RBJ::BandStop notch;
+        notch.setup(sample_rate_, frequency, q);
+        chain_.append(notch);
+        reset();
+        return *this;
+    }
+
+    FusedFilterChain &FusedFilterChain::add_derivative()
+    {
+        check_room(1);
+        chain_.appendDifferentiator(sample_rate_);
+        reset();
+        return *this;
+    }
+
+    int FusedFilterChain::tap()
+    {
+        const int stage = num_stages() - 1;
+        if (stage < 0 || (tap_mask_ >> stage) & 1u)
+        {
+            throw std::invalid_argument("FusedFilterChain: 链为空或该节已是抽头");
+        }
+        // 抽头按节序输出，后设的抽头一定在更靠后的节上
+        tap_mask_ |= 1u << stage;
+        return num_taps_++;
+    }
+
+    float FusedFilterChain::process_sample(float input, float *taps)
+    {
+        return state_.processTapped(input, chain_, tap_mask_, taps);
+    }
+
+    void FusedFilterChain::process_block(float *data, size_t n, float *const *taps)
+    {
+        state_.processBlockTapped(static_cast<int>(n), data, chain_, tap_mask_, taps);
+    }
+
+    void FusedFilterChain::reset()
+    {
+        state_.reset();
+    }
+
+    double FusedFilterChain::prime(double dc_value)
+    {
+        return state_.setSteadyState(dc_value, chain_);
+    }
+
+} // namespace ppg
@@ -0,0 +1,221 @@
+#include "filter_design_cache.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace ppg
+{
+
+    const int FilterDesignCache::kMaxOrder;
+
+    namespace
+    {
+        // 把设计好的级联拷贝为biquad系数
+        void copy_stages(const Dsp::Cascade &filter, BandPassDesign &design)
+        {
+            for (int i = 0; i < filter.getNumStages(); i++)
+            {
+                design.stages.push_back(filter[i]);
+            }
+        }
+
+        // 执行一次完整设计并提取biquad系数
+        BandPassDesignPtr design_stages(const BandPassSpec &spec, double center_frequency,
+                                          double bandwidth)
+        {
+            std::shared_ptr<BandPassDesign> design(new BandPassDesign);
+            design->family = spec.family;
+            design->order = spec.order;
+            design->sample_rate = spec.sample_rate;
+            design->center_frequency = center_frequency;
+            design->bandwidth = bandwidth;
+            design->ripple_db = spec.ripple_db;
+            design->stopband_db = spec.stopband_db;
+            design->rolloff = spec.rolloff;
+
+            const int kMaxOrder = FilterDesignCache::kMaxOrder;
+            switch (spec.family)
+            {
+            case FilterFamily::ChebyshevI:
+            {
+                Dsp::ChebyshevI::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth,
+                             spec.ripple_db);
+                copy_stages(filter, *design);
+                break;
+            }
+            case FilterFamily::ChebyshevII:
+            {
+                Dsp::ChebyshevII::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth,
+                             spec.stopband_db);
+                copy_stages(filter, *design);
+                break;
+            }
+            case FilterFamily::Elliptic:
+            {
+                Dsp::Elliptic::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth,
+                             spec.ripple_db, spec.rolloff);
+                copy_stages(filter, *design);
+                break;
+            }
+            case FilterFamily::Bessel:
+            {
+                Dsp::Bessel::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth);
+                copy_stages(filter, *design);
+                break;
+            }
+            case FilterFamily::Legendre:
+            {
+                Dsp::Legendre::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth);
+                copy_stages(filter, *design);
+                break;
+            }
+            case FilterFamily::Butterworth:
+            default:
+            {
+                Dsp::Butterworth::BandPass<kMaxOrder> filter;
+                filter.setup(spec.order, spec.sample_rate, center_frequency, bandwidth);
+                copy_stages(filter, *design);
+                break;
+            }
+            }
+
+            return design;
+        }
+
+        // DSPFilters的带通以 center ± width/2 为通带边缘，中心取算术平均；
+        // 几何平均会使下边缘为负而被截断到~0Hz，高通段退化为积分器
+        double center_of(const BandPassSpec &spec)
+        {
+            return 0.5 * (spec.low_freq + spec.high_freq);
+        }
+
+        double width_of(const BandPassSpec &spec)
+        {
+            return spec.high_freq - spec.low_freq;
+        }
+
+        struct FamilyName
+        {
+            const char *name;
+            FilterFamily family;
+        };
+
+        // 第一个出现的名称为规范名称
+        const FamilyName kFamilyNames[] = {
+            {"butterworth", FilterFamily::Butterworth},
+            {"chebyshev1", FilterFamily::ChebyshevI},
+            {"chebyshev2", FilterFamily::ChebyshevII},
+            {"elliptic", FilterFamily::Elliptic},
+            {"bessel", FilterFamily::Bessel},
+            {"legendre", FilterFamily::Legendre},
+            {"chebyshevi", FilterFamily::ChebyshevI},
+            {"chebyshevii", FilterFamily::ChebyshevII},
+            {"cheby1", FilterFamily::ChebyshevI},
+            {"cheby2", FilterFamily::ChebyshevII},
+            {"ellip", FilterFamily::Elliptic},
+        };
+    } // namespace
+
+    const char *filter_family_name(FilterFamily family)
+    {
+        for (size_t i = 0; i < sizeof(kFamilyNames) / sizeof(kFamilyNames[0]); i++)
+        {
+            if (kFamilyNames[i].family == family)
+            {
+                return kFamilyNames[i].name;
+            }
+        }
+        return "unknown";
+    }
+
+    FilterFamily parse_filter_family(const std::string &name)
+    {
+        std::string lower(name);
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        for (size_t i = 0; i < sizeof(kFamilyNames) / sizeof(kFamilyNames[0]); i++)
+        {
+            if (lower == kFamilyNames[i].name)
+            {
+                return kFamilyNames[i].family;
+            }
+        }
+        throw std::invalid_argument("parse_filter_family: 未知的滤波器族 " + name);
+    }
+
+    BandPassDesignPtr design_bandpass(const BandPassSpec &spec)
+    {
+        if (spec.order < 1 || spec.order > FilterDesignCache::kMaxOrder)
+        {
+            throw std::invalid_argument("design_bandpass: 滤波器阶数超出范围");
+        }
+        return design_stages(spec, center_of(spec), width_of(spec));
+    }
+
+    FilterDesignCache &FilterDesignCache::instance()
+    {
+        static FilterDesignCache cache;
+        return cache;
+    }
+
+    BandPassDesignPtr FilterDesignCache::get_bandpass(double low_freq, double high_freq,
+                                                      double sample_rate, int filter_order,
+                                                      FilterFamily family)
+    {
+        return get_bandpass(BandPassSpec(low_freq, high_freq, sample_rate, filter_order, family));
+    }
+
+    BandPassDesignPtr FilterDesignCache::get_bandpass(const BandPassSpec &spec)
+    {
+        if (spec.order < 1 || spec.order > kMaxOrder)
+        {
+            throw std::invalid_argument("FilterDesignCache: 滤波器阶数超出范围");
+        }
+
+        double center_frequency = center_of(spec);
+        double bandwidth = width_of(spec);
+
+        // 只有相应的族使用的参数参与键，避免无关参数产生重复设计
+        const bool uses_ripple = (spec.family == FilterFamily::ChebyshevI ||
+                                  spec.family == FilterFamily::Elliptic);
+        key_type key(static_cast<int>(spec.family), spec.order, spec.sample_rate,
+                     center_frequency, bandwidth,
+                     uses_ripple ? spec.ripple_db : 0.0,
+                     spec.family == FilterFamily::ChebyshevII ? spec.stopband_db : 0.0,
+                     spec.family == FilterFamily::Elliptic ? spec.rolloff : 0.0);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::map<key_type, BandPassDesignPtr>::const_iterator it = designs_.find(key);
+            if (it != designs_.end())
+            {
+                return it->second;
+            }
+        }
+
+        // 在锁外设计，避免阻塞其他线程的缓存命中
+        BandPassDesignPtr design = design_stages(spec, center_frequency, bandwidth);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 若其他线程已插入相同设计，则沿用已有的那一份
+        return designs_.insert(std::make_pair(key, design)).first->second;
+    }
+
+    size_t FilterDesignCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return designs_.size();
+    }
+
+    void FilterDesignCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        designs_.clear();
+    }
+
+} // namespace ppg
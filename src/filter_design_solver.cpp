@@ -0,0 +1,182 @@
+#include "filter_design_solver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ppg
+{
+
+    namespace
+    {
+        // 设计边缘从通带边缘 (0) 到阻带边缘 (1) 的扫描点数
+        const int kEdgeSteps = 20;
+
+        // Elliptic 过渡带陡度的扫描值（越大过渡带越窄、阻带衰减越小）
+        const double kEllipticRolloffs[] = {-2.0, -1.0, 0.0, 1.0, 2.0};
+
+        // 等纹波族按允许纹波的这一比例设计，给频率网格之间的纹波峰留余量
+        const double kRippleMargin = 0.95;
+
+        // 频率网格点数：通带、下阻带、上阻带
+        const int kPassbandPoints = 128;
+        const int kLowerStopbandPoints = 128;
+        const int kUpperStopbandPoints = 256;
+
+        const double kPi = 3.14159265358979323846;
+
+        // 各节频率响应之积（与 Cascade::response 相同）的幅度
+        double magnitude(const BandPassDesign &design, double frequency)
+        {
+            const double normalized = frequency / design.sample_rate;
+            Dsp::complex_t response(1.0, 0.0);
+            for (int i = 0; i < design.num_stages(); i++)
+            {
+                response *= design.stages[i].response(normalized);
+            }
+            return std::abs(response);
+        }
+
+        // 区间 [from, to] 上均匀网格的最大、最小幅度
+        void magnitude_range(const BandPassDesign &design, double from, double to, int points,
+                             double &max_gain, double &min_gain)
+        {
+            for (int i = 0; i < points; i++)
+            {
+                const double f = from + (to - from) * i / (points - 1);
+                const double gain = magnitude(design, f);
+                max_gain = std::max(max_gain, gain);
+                min_gain = std::min(min_gain, gain);
+            }
+        }
+
+        struct Evaluation
+        {
+            double ripple_db;
+            double atten_db;
+        };
+
+        // 检验设计是否满足指标；先查通带，不满足时跳过阻带网格
+        bool meets(const BandPassDesign &design, const BandPassRequirements &req,
+                   Evaluation &eval)
+        {
+            double pass_max = 0.0;
+            double pass_min = 1e300;
+            magnitude_range(design, req.pass_low, req.pass_high, kPassbandPoints,
+                            pass_max, pass_min);
+            if (pass_min <= 0.0)
+            {
+                return false;
+            }
+            eval.ripple_db = 20.0 * std::log10(pass_max / pass_min);
+            if (eval.ripple_db > req.passband_ripple_db)
+            {
+                return false;
+            }
+
+            double stop_max = 0.0;
+            double unused = 1e300;
+            magnitude_range(design, 0.0, req.stop_low, kLowerStopbandPoints, stop_max, unused);
+            magnitude_range(design, req.stop_high, 0.5 * req.sample_rate, kUpperStopbandPoints,
+                            stop_max, unused);
+            eval.atten_db = stop_max > 0.0 ? 20.0 * std::log10(pass_max / stop_max) : 1e300;
+            return eval.atten_db >= req.stopband_atten_db;
+        }
+    } // namespace
+
+    double group_delay_samples(const BandPassDesign &design, double frequency)
+    {
+        // 相位对角频率的中心差分：tau = -dphi / domega
+        const double delta = 1e-4 * design.sample_rate;
+        Dsp::complex_t lower(1.0, 0.0);
+        Dsp::complex_t upper(1.0, 0.0);
+        for (int i = 0; i < design.num_stages(); i++)
+        {
+            lower *= design.stages[i].response((frequency - delta) / design.sample_rate);
+            upper *= design.stages[i].response((frequency + delta) / design.sample_rate);
+        }
+        const double dphi = std::arg(upper * std::conj(lower));
+        const double domega = 2.0 * kPi * (2.0 * delta) / design.sample_rate;
+        return -dphi / domega;
+    }
+
+    BandPassSolution design_min_cost_bandpass(const BandPassRequirements &req)
+    {
+        if (!(req.sample_rate > 0.0 && req.stop_low > 0.0 && req.stop_low < req.pass_low &&
+              req.pass_low < req.pass_high && req.pass_high < req.stop_high &&
+              req.stop_high < 0.5 * req.sample_rate))
+        {
+            throw std::invalid_argument(
+                "design_min_cost_bandpass: 频率边缘须满足 0 < 阻带下沿 < 通带下沿 < 通带上沿 < 阻带上沿 < 采样率/2");
+        }
+        if (req.passband_ripple_db <= 0.0 || req.stopband_atten_db <= 0.0)
+        {
+            throw std::invalid_argument("design_min_cost_bandpass: 纹波和衰减必须为正");
+        }
+
+        static const FilterFamily kFamilies[] = {
+            FilterFamily::Butterworth, FilterFamily::ChebyshevI,
+            FilterFamily::ChebyshevII, FilterFamily::Elliptic};
+        const double center = 0.5 * (req.pass_low + req.pass_high);
+
+        for (int order = 1; order <= FilterDesignCache::kMaxOrder; order++)
+        {
+            bool found = false;
+            BandPassSpec best_spec(req.pass_low, req.pass_high, req.sample_rate, order);
+            Evaluation best_eval = {0.0, 0.0};
+            double best_delay = 0.0;
+
+            for (size_t f = 0; f < sizeof(kFamilies) / sizeof(kFamilies[0]); f++)
+            {
+                const FilterFamily family = kFamilies[f];
+                const bool sweeps_rolloff = (family == FilterFamily::Elliptic);
+                const size_t num_rolloffs =
+                    sweeps_rolloff ? sizeof(kEllipticRolloffs) / sizeof(kEllipticRolloffs[0]) : 1;
+
+                for (size_t r = 0; r < num_rolloffs; r++)
+                {
+                    for (int step = 0; step <= kEdgeSteps; step++)
+                    {
+                        const double t = static_cast<double>(step) / kEdgeSteps;
+                        BandPassSpec spec(req.pass_low + t * (req.stop_low - req.pass_low),
+                                          req.pass_high + t * (req.stop_high - req.pass_high),
+                                          req.sample_rate, order, family);
+                        spec.ripple_db = kRippleMargin * req.passband_ripple_db;
+                        spec.stopband_db = req.stopband_atten_db;
+                        spec.rolloff = sweeps_rolloff ? kEllipticRolloffs[r] : 0.0;
+
+                        BandPassDesignPtr candidate = design_bandpass(spec);
+                        Evaluation eval;
+                        if (!meets(*candidate, req, eval))
+                        {
+                            continue;
+                        }
+
+                        const double delay = group_delay_samples(*candidate, center);
+                        if (!found || delay < best_delay)
+                        {
+                            found = true;
+                            best_spec = spec;
+                            best_eval = eval;
+                            best_delay = delay;
+                        }
+                    }
+                }
+            }
+
+            if (found)
+            {
+                BandPassSolution solution(best_spec);
+                solution.design = FilterDesignCache::instance().get_bandpass(best_spec);
+                solution.num_stages = solution.design->num_stages();
+                solution.passband_ripple_db = best_eval.ripple_db;
+                solution.stopband_atten_db = best_eval.atten_db;
+                solution.group_delay_ms = best_delay / req.sample_rate * 1000.0;
+                solution.cycles_per_sample = kEstimatedCyclesPerStage * solution.num_stages;
+                return solution;
+            }
+        }
+
+        throw std::invalid_argument("design_min_cost_bandpass: 最大阶数内没有满足指标的设计");
+    }
+
+} // namespace ppg
@@ -28,68 +28,150 @@ std::vector<int> find_local_maxima(const std::vector<float>& signal) {
 // 步骤2: 应用distance约束 (_select_by_peak_distance)
 // =====================================================================
 
-std::vector<int> filter_peaks_by_distance(
+namespace {
+
+// 贪心选择的核心，priority(i) 为第 i 个峰值的优先级
+template <typename Priority>
+void greedy_select_by_distance(
     const std::vector<int>& peaks,
-    const std::vector<float>& signal,
-    int distance
+    Priority priority,
+    int distance,
+    std::vector<int>& priority_order,
+    std::vector<char>& keep
 ) {
-    if (distance <= 0 || peaks.empty()) {
-        return peaks;
-    }
-    
-    // 创建(索引, 高度, 原始位置)的三元组
-    struct PeakInfo {
-        int index;           // 在peaks数组中的位置
-        float height;        // 峰值高度
-        int position;        // 在信号中的位置
-    };
-    
-    std::vector<PeakInfo> peak_infos;
-    for (size_t i = 0; i < peaks.size(); i++) {
-        peak_infos.push_back({
-            static_cast<int>(i),
-            signal[peaks[i]],
-            peaks[i]
-        });
+    const int num_peaks = static_cast<int>(peaks.size());
+    keep.assign(num_peaks, 1);  // 标记哪些峰值保留
+
+    // 优先级顺序：降序；相等时位置靠右者优先，
+    // 与scipy对priority做argsort后从后往前遍历的顺序一致
+    priority_order.resize(num_peaks);
+    for (int i = 0; i < num_peaks; i++) {
+        priority_order[i] = i;
     }
-    
-    // 按高度降序排序（优先级：高度越大越优先保留）
-    std::sort(peak_infos.begin(), peak_infos.end(),
-              [](const PeakInfo& a, const PeakInfo& b) {
-                  return a.height > b.height;
+    std::sort(priority_order.begin(), priority_order.end(),
+              [&](int a, int b) {
+                  const float priority_a = priority(a);
+                  const float priority_b = priority(b);
+                  if (priority_a != priority_b) {
+                      return priority_a > priority_b;
+                  }
+                  return a > b;
               });
-    
-    // 贪心算法：从高到低选择峰值
-    std::vector<bool> keep(peaks.size(), true);  // 标记哪些峰值保留
-    
-    for (size_t i = 0; i < peak_infos.size(); i++) {
-        if (!keep[peak_infos[i].index]) {
+
+    // 贪心算法：从高到低选择峰值。peaks按位置升序，保留一个峰值时只需
+    // 向两侧检查距离以内的邻居；保留的峰值彼此相距至少distance，
+    // 每个峰值至多被左右两个保留峰值各扫描一次，扫描总量为O(P)
+    for (int i = 0; i < num_peaks; i++) {
+        const int current = priority_order[i];
+        if (!keep[current]) {
             continue;  // 已被删除
         }
-        
-        int current_pos = peak_infos[i].position;
-        
-        // 删除所有距离太近且优先级更低的峰值
-        for (size_t j = i + 1; j < peak_infos.size(); j++) {
-            int other_pos = peak_infos[j].position;
-            
-            if (std::abs(current_pos - other_pos) < distance) {
-                keep[peak_infos[j].index] = false;  // 删除优先级低的
-            }
+
+        const int current_pos = peaks[current];
+        for (int k = current - 1; k >= 0 && current_pos - peaks[k] < distance; k--) {
+            keep[k] = 0;
+        }
+        for (int k = current + 1; k < num_peaks && peaks[k] - current_pos < distance; k++) {
+            keep[k] = 0;
         }
     }
+}
+
+// 按 keep 原地压缩，保持位置顺序
+void compact_kept(std::vector<int>& peaks, const std::vector<char>& keep) {
+    size_t count = 0;
+    for (size_t i = 0; i < peaks.size(); i++) {
+        if (keep[i]) {
+            peaks[count++] = peaks[i];
+        }
+    }
+    peaks.resize(count);
+}
+
+} // namespace
+
+void select_by_peak_distance(
+    const std::vector<int>& peaks,
+    const std::vector<float>& priority,
+    int distance,
+    std::vector<char>& keep
+) {
+    std::vector<int> priority_order;
+    greedy_select_by_distance(peaks, [&](int i) { return priority[i]; },
+                              distance, priority_order, keep);
+}
+
+std::vector<int> filter_peaks_by_distance(
+    const std::vector<int>& peaks,
+    const std::vector<float>& signal,
+    int distance
+) {
+    if (distance <= 0 || peaks.empty()) {
+        return peaks;
+    }
     
+    const int num_peaks = static_cast<int>(peaks.size());
+    std::vector<int> priority_order;
+    std::vector<char> keep;
+    greedy_select_by_distance(peaks, [&](int i) { return signal[peaks[i]]; },
+                              distance, priority_order, keep);
+
     // 收集保留的峰值（按原始顺序）
     std::vector<int> filtered_peaks;
-    for (size_t i = 0; i < peaks.size(); i++) {
+    for (int i = 0; i < num_peaks; i++) {
         if (keep[i]) {
             filtered_peaks.push_back(peaks[i]);
         }
     }
-    
+
     return filtered_peaks;
 }
 
+// =====================================================================
+// 峰值与谷值一遍扫描（等价于 find_peaks(x, distance) 与 find_peaks(-x, distance)）
+// =====================================================================
+
+void find_peaks_and_valleys(
+    const std::vector<float>& signal,
+    int distance,
+    std::vector<int>& peaks,
+    std::vector<int>& valleys
+) {
+    peaks.clear();
+    valleys.clear();
+
+    if (signal.size() < 3) {
+        return;
+    }
+
+    // 一遍扫描：x[i-1] < x[i] >= x[i+1] 为峰值；
+    // x[i-1] > x[i] <= x[i+1] 即取反信号的局部最大值，为谷值
+    for (size_t i = 1; i < signal.size() - 1; i++) {
+        const float previous = signal[i - 1];
+        const float current = signal[i];
+        const float next = signal[i + 1];
+        if (previous < current && current >= next) {
+            peaks.push_back(i);
+        } else if (previous > current && current <= next) {
+            valleys.push_back(i);
+        }
+    }
+
+    if (distance <= 0) {
+        return;
+    }
+
+    // 两种极值共用排序缓冲区；谷值的优先级为取反后的高度
+    std::vector<int> priority_order;
+    std::vector<char> keep;
+    greedy_select_by_distance(peaks, [&](int i) { return signal[peaks[i]]; },
+                              distance, priority_order, keep);
+    compact_kept(peaks, keep);
+    greedy_select_by_distance(valleys, [&](int i) { return -signal[valleys[i]]; },
+                              distance, priority_order, keep);
+    compact_kept(valleys, keep);
+}
+
 // =====================================================================
 // 步骤3: 应用height约束
 // =====================================================================
@@ -126,8 +208,9 @@ float calculate_prominence(
     float peak_height = signal[peak_idx];
     
     // 向左找最低点
+    // 一侧没有更低的样本时基线记在峰值本身（与scipy、calculate_prominences一致）
     float left_min = peak_height;
-    left_base = 0;
+    left_base = peak_idx;
     for (int i = peak_idx - 1; i >= 0; i--) {
         if (signal[i] < left_min) {
             left_min = signal[i];
@@ -141,7 +224,7 @@ float calculate_prominence(
     
     // 向右找最低点
     float right_min = peak_height;
-    right_base = signal.size() - 1;
+    right_base = peak_idx;
     for (size_t i = peak_idx + 1; i < signal.size(); i++) {
         if (signal[i] < right_min) {
             right_min = signal[i];
@@ -158,19 +241,120 @@ float calculate_prominence(
     return peak_height - base_height;
 }
 
+namespace {
+
+// 单调栈中的一项：样本位置及其搜索范围内的最小值
+struct StackEntry {
+    int position;       // 样本位置
+    float min_value;    // 从该样本向搜索方向、到第一个更高样本之前的最小值
+    int min_position;   // 最小值位置（离该样本最近者）
+};
+
+// 单侧搜索：按 step 的反方向遍历信号（向左搜索时从左往右遍历），
+// 遍历到峰值时栈顶之下即为搜索方向上第一个更高的样本，
+// 出栈各项的区间最小值合并后就是峰值到该样本之间的最小值。
+// 窗口截断时改用滑动窗口最小值（单调队列）。
+void search_side(
+    const std::vector<float>& signal,
+    const std::vector<int>& peaks,
+    int step,
+    int half_window,
+    std::vector<float>& side_min,
+    std::vector<int>& side_base
+) {
+    const int n = static_cast<int>(signal.size());
+    const int num_peaks = static_cast<int>(peaks.size());
+
+    std::vector<StackEntry> stack;
+    std::vector<int> window(n);     // 单调队列（值严格递增），window[head, tail)
+    int head = 0;
+    int tail = 0;
+
+    int k = (step < 0) ? 0 : num_peaks - 1;
+    const int k_step = (step < 0) ? 1 : -1;
+
+    for (int i = 0; i < n && k >= 0 && k < num_peaks; i++) {
+        const int pos = (step < 0) ? i : n - 1 - i;
+        const float value = signal[pos];
+
+        // 合并所有不高于当前样本的栈顶区间；等值时保留离当前样本更近的位置
+        StackEntry entry = { pos, value, pos };
+        while (!stack.empty() && signal[stack.back().position] <= value) {
+            if (stack.back().min_value < entry.min_value) {
+                entry.min_value = stack.back().min_value;
+                entry.min_position = stack.back().min_position;
+            }
+            stack.pop_back();
+        }
+        // 到第一个更高样本（或信号边缘）之前的样本数
+        const int reach = stack.empty() ? i : std::abs(pos - stack.back().position) - 1;
+        stack.push_back(entry);
+
+        if (half_window > 0) {
+            while (tail > head && signal[window[tail - 1]] >= value) {
+                tail--;
+            }
+            window[tail++] = pos;
+            if (std::abs(pos - window[head]) > half_window) {
+                head++;
+            }
+        }
+
+        while (k >= 0 && k < num_peaks && peaks[k] == pos) {
+            if (half_window > 0 && half_window < reach) {
+                side_min[k] = signal[window[head]];
+                side_base[k] = window[head];
+            } else {
+                side_min[k] = entry.min_value;
+                side_base[k] = entry.min_position;
+            }
+            k += k_step;
+        }
+    }
+}
+
+} // namespace
+
+void calculate_prominences(
+    const std::vector<float>& signal,
+    const std::vector<int>& peaks,
+    std::vector<float>& prominences,
+    std::vector<int>& left_bases,
+    std::vector<int>& right_bases,
+    int wlen
+) {
+    const size_t num_peaks = peaks.size();
+    const int half_window = (wlen >= 2) ? wlen / 2 : 0;
+
+    std::vector<float> left_min(num_peaks);
+    std::vector<float> right_min(num_peaks);
+    left_bases.assign(num_peaks, 0);
+    right_bases.assign(num_peaks, 0);
+
+    search_side(signal, peaks, -1, half_window, left_min, left_bases);
+    search_side(signal, peaks, 1, half_window, right_min, right_bases);
+
+    // Prominence = 峰值 - 两侧最低点中的较高者
+    prominences.resize(num_peaks);
+    for (size_t i = 0; i < num_peaks; i++) {
+        prominences[i] = signal[peaks[i]] - std::max(left_min[i], right_min[i]);
+    }
+}
+
 std::vector<int> filter_peaks_by_prominence(
     const std::vector<int>& peaks,
     const std::vector<float>& signal,
-    float min_prominence
+    float min_prominence,
+    int wlen
 ) {
+    std::vector<float> prominences;
+    std::vector<int> left_bases, right_bases;
+    calculate_prominences(signal, peaks, prominences, left_bases, right_bases, wlen);
+
     std::vector<int> filtered_peaks;
-    
-    for (int peak_idx : peaks) {
-        int left_base, right_base;
-        float prom = calculate_prominence(signal, peak_idx, left_base, right_base);
-        
-        if (prom >= min_prominence) {
-            filtered_peaks.push_back(peak_idx);
+    for (size_t i = 0; i < peaks.size(); i++) {
+        if (prominences[i] >= min_prominence) {
+            filtered_peaks.push_back(peaks[i]);
         }
     }
     
@@ -185,7 +369,8 @@ std::vector<int> find_peaks(
     const std::vector<float>& signal,
     int distance,
     float min_height,
-    float min_prominence
+    float min_prominence,
+    int wlen
 ) {
     // 步骤1：找到所有局部最大值
     std::vector<int> peaks = find_local_maxima(signal);
@@ -194,20 +379,20 @@ std::vector<int> find_peaks(
         return peaks;
     }
     
-    // // 步骤2：应用height约束
-    // if (std::isfinite(min_height)) {
-    //     peaks = filter_peaks_by_height(peaks, signal, min_height);
-    // }
+    // 步骤2：应用height约束
+    if (std::isfinite(min_height)) {
+        peaks = filter_peaks_by_height(peaks, signal, min_height);
+    }
     
     // 步骤3：应用distance约束（核心！）
     if (distance > 0) {
         peaks = filter_peaks_by_distance(peaks, signal, distance);
     }
     
-    // // 步骤4：应用prominence约束
-    // if (min_prominence >= 0.0f) {
-    //     peaks = filter_peaks_by_prominence(peaks, signal, min_prominence);
-    // }
+    // 步骤4：应用prominence约束（一次计算全部显著性，O(N + P)）
+    if (min_prominence >= 0.0f) {
+        peaks = filter_peaks_by_prominence(peaks, signal, min_prominence, wlen);
+    }
     
     return peaks;
 }
@@ -222,27 +407,21 @@ void find_peaks_with_properties(
     PeakProperties& properties,
     int distance,
     float min_height,
-    float min_prominence
+    float min_prominence,
+    int wlen
 ) {
     // 找峰值
-    peaks = find_peaks(signal, distance, min_height, min_prominence);
+    peaks = find_peaks(signal, distance, min_height, min_prominence, wlen);
     
     // 计算属性
     properties.peak_heights.clear();
-    properties.prominences.clear();
-    properties.left_bases.clear();
-    properties.right_bases.clear();
-    
     for (int peak_idx : peaks) {
         // 高度
         properties.peak_heights.push_back(signal[peak_idx]);
-        
-        // 显著性
-        int left_base, right_base;
-        float prom = calculate_prominence(signal, peak_idx, left_base, right_base);
-        properties.prominences.push_back(prom);
-        properties.left_bases.push_back(left_base);
-        properties.right_bases.push_back(right_base);
     }
+
+    // 显著性与基线（一次计算全部峰值）
+    calculate_prominences(signal, peaks, properties.prominences,
+                          properties.left_bases, properties.right_bases, wlen);
 }
 
@@ -0,0 +1,230 @@
+#include "parallel_filter.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ppg {
+
+namespace {
+
+typedef Dsp::CascadeStages<kParallelMaxStages>::State<Dsp::TransposedDirectFormII> ChunkState;
+
+// 状态维数上限（每节2个TDF-II状态）
+const int kMaxDim = 2 * kParallelMaxStages;
+
+// 零输入响应每隔多少样本检查一次衰减
+const size_t kDecayCheckInterval = 256;
+
+// 零输入响应相对初始状态衰减到该比例以下即视为0
+const double kDecayTolerance = 1e-15;
+
+// 行主序的 dim x dim 方阵
+typedef std::vector<double> Matrix;
+
+// 级联在零输入下前进一步（TDF-II），返回该步输出，v原地更新
+double zero_input_step(const Dsp::Cascade& cascade, double* v) {
+    double in = 0.0;
+    const int num_stages = cascade.getNumStages();
+    for (int i = 0; i < num_stages; i++, v += 2) {
+        const Dsp::Cascade::Stage& s = cascade[i];
+        const double out = v[0] + s.m_b0 * in;
+        v[0] = v[1] + s.m_b1 * in - s.m_a1 * out;
+        v[1] = s.m_b2 * in - s.m_a2 * out;
+        in = out;
+    }
+    return in;
+}
+
+Matrix multiply(const Matrix& a, const Matrix& b, int dim) {
+    Matrix c(dim * dim, 0.0);
+    for (int i = 0; i < dim; i++) {
+        for (int k = 0; k < dim; k++) {
+            const double aik = a[i * dim + k];
+            if (aik == 0.0) {
+                continue;
+            }
+            for (int j = 0; j < dim; j++) {
+                c[i * dim + j] += aik * b[k * dim + j];
+            }
+        }
+    }
+    return c;
+}
+
+// A^steps，A的第j列为单位状态e_j零输入前进一步后的状态
+Matrix transition_power(const Dsp::Cascade& cascade, size_t steps) {
+    const int dim = 2 * cascade.getNumStages();
+
+    Matrix a(dim * dim, 0.0);
+    for (int j = 0; j < dim; j++) {
+        double v[kMaxDim] = {0.0};
+        v[j] = 1.0;
+        zero_input_step(cascade, v);
+        for (int i = 0; i < dim; i++) {
+            a[i * dim + j] = v[i];
+        }
+    }
+
+    Matrix result(dim * dim, 0.0);
+    for (int i = 0; i < dim; i++) {
+        result[i * dim + i] = 1.0;
+    }
+    while (steps > 0) {
+        if (steps & 1) {
+            result = multiply(result, a, dim);
+        }
+        steps >>= 1;
+        if (steps > 0) {
+            a = multiply(a, a, dim);
+        }
+    }
+    return result;
+}
+
+// y = m · x + y
+void multiply_add(const Matrix& m, const double* x, double* y, int dim) {
+    for (int i = 0; i < dim; i++) {
+        double sum = y[i];
+        for (int j = 0; j < dim; j++) {
+            sum += m[i * dim + j] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+// 处理顺序中的第p个样本
+inline float& sample_at(float* data, size_t n, size_t p, bool reverse) {
+    return reverse ? data[n - 1 - p] : data[p];
+}
+
+// 顺序滤波 [begin, end)（处理顺序下标），state为输入/输出状态（可为nullptr）
+void filter_range(const Dsp::Cascade& cascade, float* data, size_t n,
+                  size_t begin, size_t end, bool reverse, double* state) {
+    ChunkState chunk_state;
+    if (state) {
+        chunk_state.setState(state, cascade);
+    }
+    if (end > begin) {
+        chunk_state.processBlock(static_cast<int>(end - begin),
+                                 &sample_at(data, n, begin, reverse), cascade,
+                                 reverse ? -1 : 1);
+    }
+    if (state) {
+        chunk_state.getState(state, cascade);
+    }
+}
+
+// 叠加由状态s出发的零输入响应，衰减到可忽略时提前结束
+void add_zero_input_response(const Dsp::Cascade& cascade, float* data, size_t n,
+                             size_t begin, size_t end, bool reverse, const double* s) {
+    const int dim = 2 * cascade.getNumStages();
+    double v[kMaxDim];
+    double scale = 0.0;
+    for (int i = 0; i < dim; i++) {
+        v[i] = s[i];
+        scale = std::max(scale, std::fabs(s[i]));
+    }
+    if (scale == 0.0) {
+        return;
+    }
+
+    for (size_t p = begin; p < end; p++) {
+        float& x = sample_at(data, n, p, reverse);
+        x = static_cast<float>(x + zero_input_step(cascade, v));
+
+        if ((p - begin) % kDecayCheckInterval == kDecayCheckInterval - 1) {
+            // 已衰减到可忽略的分量直接置0，避免快速衰减的节进入非规格化数（极慢）
+            double remaining = 0.0;
+            for (int i = 0; i < dim; i++) {
+                if (std::fabs(v[i]) < kDecayTolerance * scale) {
+                    v[i] = 0.0;
+                }
+                remaining = std::max(remaining, std::fabs(v[i]));
+            }
+            if (remaining == 0.0) {
+                break;
+            }
+        }
+    }
+}
+
+template<typename Function>
+void run_parallel(int count, Function fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    for (int k = 1; k < count; k++) {
+        workers.push_back(std::thread(fn, k));
+    }
+    fn(0);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+} // namespace
+
+void parallel_cascade_filter(const Dsp::Cascade& cascade, float* data, size_t n,
+                             double* state, bool reverse, int num_threads) {
+    const int num_stages = cascade.getNumStages();
+    if (num_stages > kParallelMaxStages) {
+        throw std::invalid_argument("parallel_cascade_filter: 级联节数超出范围");
+    }
+    if (n == 0) {
+        return;
+    }
+
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t max_chunks = std::max<size_t>(1, n / kParallelMinChunk);
+    const int num_chunks = static_cast<int>(std::min<size_t>(num_threads, max_chunks));
+
+    if (num_chunks == 1) {
+        filter_range(cascade, data, n, 0, n, reverse, state);
+        return;
+    }
+
+    const int dim = 2 * num_stages;
+    const size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+    std::vector<double> chunk_begin_state(num_chunks * dim, 0.0);
+    std::vector<double> chunk_end_state(num_chunks * dim, 0.0);
+
+    // 第一步：各块零初值并行滤波，记录块末状态
+    run_parallel(num_chunks, [&](int k) {
+        const size_t begin = k * chunk_size;
+        const size_t end = std::min(n, begin + chunk_size);
+        filter_range(cascade, data, n, begin, end, reverse, &chunk_end_state[k * dim]);
+    });
+
+    // 第二步：顺序递推各块的真实块首状态
+    const Matrix full_power = transition_power(cascade, chunk_size);
+    if (state) {
+        std::copy(state, state + dim, chunk_begin_state.begin());
+    }
+    for (int k = 1; k < num_chunks; k++) {
+        double* s = &chunk_begin_state[k * dim];
+        std::copy(&chunk_end_state[(k - 1) * dim], &chunk_end_state[k * dim], s);
+        multiply_add(full_power, &chunk_begin_state[(k - 1) * dim], s, dim);
+    }
+    if (state) {
+        const size_t last_begin = (num_chunks - 1) * chunk_size;
+        const Matrix last_power = transition_power(cascade, n - last_begin);
+        std::vector<double> end_state(&chunk_end_state[(num_chunks - 1) * dim],
+                                      &chunk_end_state[num_chunks * dim]);
+        multiply_add(last_power, &chunk_begin_state[(num_chunks - 1) * dim],
+                     end_state.data(), dim);
+        std::copy(end_state.begin(), end_state.end(), state);
+    }
+
+    // 第三步：各块并行叠加块首状态的零输入响应
+    run_parallel(num_chunks, [&](int k) {
+        const size_t begin = k * chunk_size;
+        const size_t end = std::min(n, begin + chunk_size);
+        add_zero_input_response(cascade, data, n, begin, end, reverse,
+                                &chunk_begin_state[k * dim]);
+    });
+}
+
+} // namespace ppg
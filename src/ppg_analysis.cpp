@@ -17,7 +17,8 @@ namespace ppg
         double min_time_interval,
         std::vector<int> &peaks,
         std::vector<int> &valleys,
-        float &ac_component)
+        float &ac_component,
+        BeatRecords *beats)
     {
         std::cout << "\n【峰值检测】" << std::endl;
 
@@ -28,17 +29,9 @@ namespace ppg
         std::cout << "  最小峰值间距: " << min_distance << " 样本 ("
                   << min_time_interval << " 秒)" << std::endl;
 
-        // 找峰值
-        peaks = find_peaks(filtered_signal, min_distance);
+        // 一遍扫描同时找峰值和谷值（谷值即取反信号的峰值，不复制信号）
+        find_peaks_and_valleys(filtered_signal, min_distance, peaks, valleys);
         std::cout << "  检测到峰值数量: " << peaks.size() << std::endl;
-
-        // 找谷值（信号取反）
-        std::vector<float> inverted_signal = filtered_signal;
-        for (float &val : inverted_signal)
-        {
-            val = -val;
-        }
-        valleys = find_peaks(inverted_signal, min_distance);
         std::cout << "  检测到谷值数量: " << valleys.size() << std::endl;
 
         // 打印前5个峰值
@@ -69,64 +62,86 @@ namespace ppg
             }
         }
 
-        // 计算平均AC分量（峰峰值）- 改进版：匹配峰值前后的谷值
-        ac_component = 0.0f;
-        if (!peaks.empty() && !valleys.empty())
+        // 逐搏配对，平均AC分量（峰峰值）由逐搏幅度导出
+        BeatRecords local_beats;
+        BeatRecords &beat_records = beats ? *beats : local_beats;
+        pair_beats(filtered_signal, peaks, valleys, beat_records);
+        ac_component = beat_records.mean_amplitude();
+        if (beat_records.size() > 0)
         {
-            float sum_ac = 0;
-            int count = 0;
+            std::cout << "\n  配对心搏数: " << beat_records.size() << std::endl;
+            std::cout << "  平均AC分量（峰峰值）: " << std::fixed
+                      << std::setprecision(2) << ac_component << std::endl;
+        }
+
+        std::cout << "  峰值检测完成！" << std::endl;
+    }
 
-            for (int peak_idx : peaks)
+    // ===================== AC分量计算函数 =====================
+
+    void pair_beats(
+        const std::vector<float> &filtered_signal,
+        const std::vector<int> &peaks,
+        const std::vector<int> &valleys,
+        BeatRecords &beats)
+    {
+        beats.clear();
+
+        // 双指针：next 指向第一个不早于当前峰值的谷值，峰值升序时只会前进
+        size_t next = 0;
+        for (int peak_idx : peaks)
+        {
+            while (next < valleys.size() && valleys[next] < peak_idx)
+            {
+                next++;
+            }
+            size_t after = next;
+            if (after < valleys.size() && valleys[after] == peak_idx)
             {
-                // 找峰值前后最近的两个谷值
-                int valley_before = -1;
-                int valley_after = -1;
-
-                for (int valley_idx : valleys)
-                {
-                    if (valley_idx < peak_idx)
-                    {
-                        if (valley_before == -1 || valley_idx > valley_before)
-                            valley_before = valley_idx;
-                    }
-                    else if (valley_idx > peak_idx)
-                    {
-                        if (valley_after == -1 || valley_idx < valley_after)
-                            valley_after = valley_idx;
-                    }
-                }
-
-                // 使用前后谷值的平均值
-                if (valley_before >= 0 && valley_after >= 0)
-                {
-                    float valley_avg = (filtered_signal[valley_before] + filtered_signal[valley_after]) / 2.0f;
-                    float ac = filtered_signal[peak_idx] - valley_avg;
-                    sum_ac += ac;
-                    count++;
-                }
-                else if (valley_before >= 0)
-                {
-                    float ac = filtered_signal[peak_idx] - filtered_signal[valley_before];
-                    sum_ac += ac;
-                    count++;
-                }
-                else if (valley_after >= 0)
-                {
-                    float ac = filtered_signal[peak_idx] - filtered_signal[valley_after];
-                    sum_ac += ac;
-                    count++;
-                }
+                after++;
             }
 
-            if (count > 0)
+            const int valley_before = (next > 0) ? valleys[next - 1] : -1;
+            const int valley_after = (after < valleys.size()) ? valleys[after] : -1;
+            if (valley_before < 0 && valley_after < 0)
             {
-                ac_component = sum_ac / count;
-                std::cout << "\n  平均AC分量（峰峰值）: " << std::fixed
-                          << std::setprecision(2) << ac_component << std::endl;
+                continue;
             }
+
+            // 使用前后谷值的平均值
+            float ac;
+            if (valley_before >= 0 && valley_after >= 0)
+            {
+                float valley_avg = (filtered_signal[valley_before] + filtered_signal[valley_after]) / 2.0f;
+                ac = filtered_signal[peak_idx] - valley_avg;
+            }
+            else if (valley_before >= 0)
+            {
+                ac = filtered_signal[peak_idx] - filtered_signal[valley_before];
+            }
+            else
+            {
+                ac = filtered_signal[peak_idx] - filtered_signal[valley_after];
+            }
+
+            beats.peaks.push_back(peak_idx);
+            beats.valleys_before.push_back(valley_before);
+            beats.valleys_after.push_back(valley_after);
+            beats.amplitudes.push_back(ac);
+            beats.rise_samples.push_back(valley_before >= 0 ? peak_idx - valley_before : -1);
         }
+    }
 
-        std::cout << "  峰值检测完成！" << std::endl;
+    bool calculate_ac_component(
+        const std::vector<float> &filtered_signal,
+        const std::vector<int> &peaks,
+        const std::vector<int> &valleys,
+        float &ac_component)
+    {
+        BeatRecords beats;
+        pair_beats(filtered_signal, peaks, valleys, beats);
+        ac_component = beats.mean_amplitude();
+        return beats.size() > 0;
     }
 
     // ===================== SpO2计算函数 =====================
@@ -1,9 +1,14 @@
 #include "ppg_filters.hpp"
+#include "filter_design_cache.hpp"
 #include "DspFilters/Dsp.h"
 #include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <complex>
+#include <limits>
+#include <chrono>
+#include <stdexcept>
 
 namespace ppg {
 
@@ -14,24 +19,44 @@ std::vector<float> apply_bandpass_zerophase(
     double low_freq,
     double high_freq,
     double sample_rate,
-    int filter_order
+    int filter_order,
+    int num_threads,
+    FilterKernel kernel
+) {
+    return apply_bandpass_zerophase(input_signal,
+                                    BandPassSpec(low_freq, high_freq, sample_rate, filter_order),
+                                    num_threads, kernel);
+}
+
+std::vector<float> apply_bandpass_zerophase(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec,
+    int num_threads,
+    FilterKernel kernel
 ) {
     std::cout << "\n【零相位滤波】" << std::endl;
     std::cout << "  方法: filtfilt (正向+反向)" << std::endl;
+    if (spec.family != FilterFamily::Butterworth) {
+        std::cout << "  滤波器族: " << filter_family_name(spec.family) << std::endl;
+    }
+    if (num_threads == 1 && kernel == FilterKernel::StateSpace) {
+        std::cout << "  内核: 分块状态空间" << std::endl;
+    }
     
-    // 计算中心频率和带宽
-    double center_frequency = std::sqrt(low_freq * high_freq);
-    double bandwidth = high_freq - low_freq;
-    
-    // 创建滤波器
+    // 创建滤波器（系数来自设计缓存，级联只承载系数，与族无关）
     Dsp::SimpleFilter<Dsp::Butterworth::BandPass<5>, 1> filter;
-    filter.setup(filter_order, sample_rate, center_frequency, bandwidth);
+    BandPassDesignPtr design = FilterDesignCache::instance().get_bandpass(spec);
+    if (design->num_stages() > filter.MaxStages) {
+        throw std::invalid_argument("apply_bandpass_zerophase: 设计的节数超出范围");
+    }
+    filter.setStages(design->stages.data(), design->num_stages());
     
     // 复制输入信号
     std::vector<float> output_signal = input_signal;
     
     // 应用filtfilt
-    filtfilt(filter, output_signal.data(), output_signal.size());
+    filtfilt(filter, output_signal.data(), output_signal.size(),
+             PadType::Odd, -1, nullptr, 0, num_threads, kernel);
     
     std::cout << "  零相位滤波完成！" << std::endl;
     
@@ -46,22 +71,42 @@ std::vector<float> apply_bandpass_oneway(
     double high_freq,
     double sample_rate,
     int filter_order,
-    bool use_warmup
+    bool use_warmup,
+    int num_threads,
+    FilterKernel kernel
+) {
+    return apply_bandpass_oneway(input_signal,
+                                 BandPassSpec(low_freq, high_freq, sample_rate, filter_order),
+                                 use_warmup, num_threads, kernel);
+}
+
+std::vector<float> apply_bandpass_oneway(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec,
+    bool use_warmup,
+    int num_threads,
+    FilterKernel kernel
 ) {
     std::cout << "\n【单向IIR滤波】" << std::endl;
     std::cout << "  方法: 单向正向滤波" << std::endl;
-    std::cout << "  预计群延迟: ~" << filter_order / (2 * M_PI * low_freq) * 1000 
+    if (spec.family != FilterFamily::Butterworth) {
+        std::cout << "  滤波器族: " << filter_family_name(spec.family) << std::endl;
+    }
+    std::cout << "  预计群延迟: ~" << spec.order / (2 * M_PI * spec.low_freq) * 1000 
               << " ms" << std::endl;
     
-    // 计算中心频率和带宽
-    double center_frequency = std::sqrt(low_freq * high_freq);
-    double bandwidth = high_freq - low_freq;
+    // 创建滤波器（系数来自设计缓存，级联只承载系数，与族无关）
+    Dsp::Butterworth::BandPass<5> filter;
+    BandPassDesignPtr design = FilterDesignCache::instance().get_bandpass(spec);
+    if (design->num_stages() > filter.MaxStages) {
+        throw std::invalid_argument("apply_bandpass_oneway: 设计的节数超出范围");
+    }
+    filter.setStages(design->stages.data(), design->num_stages());
     
-    // 创建滤波器
-    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<5>, 1> filter;
-    filter.setup(filter_order, sample_rate, center_frequency, bandwidth);
+    // TDF-II状态；并行模式下其稳态作为并行滤波的初始状态
+    Dsp::Butterworth::BandPass<5>::State<Dsp::TransposedDirectFormII> state;
     
-    // ========== 均值初始化预热 ==========
+    // ========== 均值稳态初始化 ==========
     if (use_warmup && input_signal.size() > 100) {
         // 计算前100个样本的均值
         int warmup_samples = std::min(100, (int)input_signal.size());
@@ -71,31 +116,437 @@ std::vector<float> apply_bandpass_oneway(
         }
         mean /= warmup_samples;
         
-        // 使用均值预热滤波器（约50次迭代）
-        int warmup_iterations = 50;
-        for (int i = 0; i < warmup_iterations; i++) {
-            float temp = mean;
-            float* p = &temp;
-            filter.process(1, &p);
-        }
+        // 直接求解均值输入下的稳态（lfilter_zi），代替有限次数的迭代预热
+        state.setSteadyState(mean, filter);
         
         std::cout << "  滤波器预热: 是 (均值=" << std::fixed << std::setprecision(2) 
-                  << mean << ", 迭代次数=" << warmup_iterations << ")" << std::endl;
+                  << mean << ", 稳态初始化)" << std::endl;
     } else {
         std::cout << "  滤波器预热: 否" << std::endl;
     }
     
-    // ========== 滤波处理 ==========
+    // ========== 滤波处理（按块送入级联滤波器）==========
     std::vector<float> output_signal = input_signal;
-    for (size_t i = 0; i < output_signal.size(); i++) {
-        float* p = &output_signal[i];
-        filter.process(1, &p);
+    if (num_threads != 1) {
+        double chunk_state[2 * kParallelMaxStages];
+        state.getState(chunk_state, filter);
+        parallel_cascade_filter(filter, output_signal.data(), output_signal.size(),
+                                chunk_state, false, num_threads);
+        std::cout << "  单向滤波完成！（分块并行）" << std::endl;
+        return output_signal;
+    }
+    
+    if (kernel == FilterKernel::StateSpace) {
+        // 每16个样本一次矩阵-向量乘，状态沿用TDF-II布局
+        double block_state[2 * kParallelMaxStages];
+        state.getState(block_state, filter);
+        Dsp::BlockStateSpace<5> block_kernel(filter);
+        block_kernel.process(static_cast<int>(output_signal.size()), output_signal.data(),
+                             block_state);
+        std::cout << "  单向滤波完成！（分块状态空间）" << std::endl;
+        return output_signal;
     }
+
+    // 整段信号按级优先（stage-major）分块处理
+    filter.processBlock(static_cast<int>(output_signal.size()), output_signal.data(), state);
     
     std::cout << "  单向滤波完成！" << std::endl;
     
     return output_signal;
 }
 
+// ===================== 数值精度评估 =====================
+
+namespace {
+
+typedef Dsp::Butterworth::BandPass<5> PrecisionDesign;
+typedef Dsp::PrecisionCascade<5, double> DoubleCascade;
+typedef Dsp::PrecisionCascade<5, float> FloatCascade;
+
+// 以双精度复数运算计算float系数级联的频率响应
+std::complex<double> float_cascade_response(const FloatCascade& cascade,
+                                            double normalized_frequency) {
+    const double w = 2 * M_PI * normalized_frequency;
+    const std::complex<double> z1 = std::polar(1.0, -w);
+    const std::complex<double> z2 = std::polar(1.0, -2 * w);
+    std::complex<double> h(1.0);
+    for (int i = 0; i < cascade.getNumStages(); i++) {
+        const FloatCascade::Stage& s = cascade[i];
+        std::complex<double> num = double(s.m_b0) + double(s.m_b1) * z1 + double(s.m_b2) * z2;
+        std::complex<double> den = 1.0 + double(s.m_a1) * z1 + double(s.m_a2) * z2;
+        h *= num / den;
+    }
+    return h;
+}
+
+template<class StateType>
+PrecisionReport run_float_form(const char* name,
+                               const FloatCascade& cascade,
+                               const std::vector<float>& input_signal,
+                               const std::vector<float>& reference,
+                               double passband_error_db) {
+    std::vector<float> output = input_signal;
+    typename FloatCascade::template State<StateType> state;
+    cascade.process(static_cast<int>(output.size()), output.data(), state);
+
+    double max_err = 0.0, err_energy = 0.0, ref_energy = 0.0;
+    for (size_t i = 0; i < output.size(); i++) {
+        double diff = static_cast<double>(output[i]) - reference[i];
+        max_err = std::max(max_err, std::fabs(diff));
+        err_energy += diff * diff;
+        ref_energy += static_cast<double>(reference[i]) * reference[i];
+    }
+
+    PrecisionReport report;
+    report.form = name;
+    report.max_abs_error = max_err;
+    report.rms_error = output.empty() ? 0.0 : std::sqrt(err_energy / output.size());
+    report.snr_db = err_energy > 0.0 ? 10.0 * std::log10(ref_energy / err_energy)
+                                     : std::numeric_limits<double>::infinity();
+    report.passband_error_db = passband_error_db;
+    return report;
+}
+
+} // namespace
+
+std::vector<PrecisionReport> compare_float_precision(
+    const std::vector<float>& input_signal,
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order
+) {
+    return compare_float_precision(input_signal,
+                                   BandPassSpec(low_freq, high_freq, sample_rate, filter_order));
+}
+
+std::vector<PrecisionReport> compare_float_precision(
+    const std::vector<float>& input_signal,
+    const BandPassSpec& spec
+) {
+    std::cout << "\n【单精度/双精度滤波精度对比】" << std::endl;
+
+    // 系数来自设计缓存，与实际滤波路径使用的设计相同
+    PrecisionDesign design;
+    BandPassDesignPtr cached = FilterDesignCache::instance().get_bandpass(spec);
+    if (cached->num_stages() > design.MaxStages) {
+        throw std::invalid_argument("compare_float_precision: 设计的节数超出范围");
+    }
+    design.setStages(cached->stages.data(), cached->num_stages());
+    const double low_freq = spec.low_freq;
+    const double high_freq = spec.high_freq;
+    const double sample_rate = spec.sample_rate;
+    DoubleCascade double_cascade(design);
+    FloatCascade float_cascade(design);
+
+    // 双精度参考输出
+    std::vector<float> reference = input_signal;
+    DoubleCascade::State<Dsp::DirectFormII> double_state;
+    double_cascade.process(static_cast<int>(reference.size()), reference.data(), double_state);
+
+    // 通带内幅频响应偏差（系数量化）
+    const int num_points = 64;
+    double passband_error_db = 0.0;
+    for (int i = 0; i < num_points; i++) {
+        double f = low_freq * std::pow(high_freq / low_freq, i / double(num_points - 1));
+        double ref_mag = std::abs(design.response(f / sample_rate));
+        double float_mag = std::abs(float_cascade_response(float_cascade, f / sample_rate));
+        passband_error_db = std::max(passband_error_db,
+                                     std::fabs(20.0 * std::log10(float_mag / ref_mag)));
+    }
+
+    std::vector<PrecisionReport> reports;
+    reports.push_back(run_float_form<Dsp::DirectFormIIFloat>(
+        "DirectFormII<float>", float_cascade, input_signal, reference, passband_error_db));
+    reports.push_back(run_float_form<Dsp::TransposedDirectFormIIFloat>(
+        "TransposedDirectFormII<float>", float_cascade, input_signal, reference, passband_error_db));
+    reports.push_back(run_float_form<Dsp::DirectFormIFloat>(
+        "DirectFormI<float>", float_cascade, input_signal, reference, passband_error_db));
+
+    std::cout << "  通带: " << low_freq << "-" << high_freq << " Hz @ " << sample_rate
+              << " Hz, 阶数: " << spec.order << std::endl;
+    std::cout << "  通带幅频偏差 (系数量化): " << std::setprecision(4)
+              << passband_error_db << " dB" << std::endl;
+    for (size_t i = 0; i < reports.size(); i++) {
+        std::cout << "  " << std::left << std::setw(32) << reports[i].form << std::right
+                  << " 最大误差: " << reports[i].max_abs_error
+                  << ", RMS误差: " << reports[i].rms_error
+                  << ", SNR: " << reports[i].snr_db << " dB" << std::endl;
+    }
+
+    return reports;
+}
+
+// ===================== 滤波内核吞吐量评估 =====================
+
+namespace {
+
+typedef Dsp::Butterworth::BandPass<5> BenchmarkDesign;
+
+// 逐样本：每个样本依次经过所有节
+template<class StateType>
+void run_sample_major(const BenchmarkDesign& design, std::vector<float>& data) {
+    typename BenchmarkDesign::template State<StateType> state;
+    design.process(static_cast<int>(data.size()), data.data(), state);
+}
+
+// 级优先：整块依次经过每一节
+template<class StateType>
+void run_stage_major(const BenchmarkDesign& design, std::vector<float>& data) {
+    typename BenchmarkDesign::template State<StateType> state;
+    design.processBlock(static_cast<int>(data.size()), data.data(), state);
+}
+
+// 并联：部分分式展开后各节独立计算再求和
+void run_parallel_form(const BenchmarkDesign& design, std::vector<float>& data) {
+    Dsp::ParallelForm<5> parallel(design);
+    Dsp::ParallelForm<5>::State state;
+    parallel.process(static_cast<int>(data.size()), data.data(), state);
+}
+
+// 分块状态空间：每块一次矩阵-向量乘
+void run_state_space(const BenchmarkDesign& design, std::vector<float>& data) {
+    Dsp::BlockStateSpace<5> block_kernel(design);
+    double state[2 * 5] = {0.0};
+    block_kernel.process(static_cast<int>(data.size()), data.data(), state);
+}
+
+typedef void (*KernelFunction)(const BenchmarkDesign&, std::vector<float>&);
+
+// 多次运行取最短耗时，output为最后一次的输出
+ThroughputReport time_kernel(const char* name,
+                             KernelFunction kernel,
+                             const BenchmarkDesign& design,
+                             const std::vector<float>& input_signal,
+                             int repetitions,
+                             std::vector<float>& output) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int r = 0; r < std::max(1, repetitions); r++) {
+        output = input_signal;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        kernel(design, output);
+        std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+
+    ThroughputReport report;
+    report.method = name;
+    report.ns_per_sample = input_signal.empty() ? 0.0 : best / input_signal.size();
+    report.speedup = 1.0;
+    report.max_abs_error = 0.0;
+    return report;
+}
+
+struct Kernel {
+    const char* name;
+    KernelFunction function;
+};
+
+} // namespace
+
+std::vector<ThroughputReport> benchmark_filter_kernels(
+    const std::vector<float>& input_signal,
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order,
+    int repetitions
+) {
+    std::cout << "\n【滤波内核吞吐量对比】" << std::endl;
+
+    BenchmarkDesign design;
+    BandPassDesignPtr cached = FilterDesignCache::instance().get_bandpass(
+        low_freq, high_freq, sample_rate, filter_order);
+    if (cached->num_stages() > design.MaxStages) {
+        throw std::invalid_argument("benchmark_filter_kernels: 设计的节数超出范围");
+    }
+    design.setStages(cached->stages.data(), cached->num_stages());
+
+    const Kernel kernels[] = {
+        { "TDF-II 逐样本 (sample-major)", &run_sample_major<Dsp::TransposedDirectFormII> },
+        { "TDF-II 级优先 (stage-major)",  &run_stage_major<Dsp::TransposedDirectFormII> },
+        { "DF-II 逐样本 (sample-major)",  &run_sample_major<Dsp::DirectFormII> },
+        { "DF-II 级优先 (stage-major)",   &run_stage_major<Dsp::DirectFormII> },
+        { "DF-I 逐样本 (sample-major)",   &run_sample_major<Dsp::DirectFormI> },
+        { "DF-I 级优先 (stage-major)",    &run_stage_major<Dsp::DirectFormI> },
+        { "并联二阶节 (parallel-form)",   &run_parallel_form },
+        { "分块状态空间 (state-space)",   &run_state_space },
+    };
+
+    std::vector<ThroughputReport> reports;
+    std::vector<float> reference, output;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        ThroughputReport report = time_kernel(kernels[k].name, kernels[k].function, design,
+                                              input_signal, repetitions, output);
+        if (k == 0) {
+            reference = output;
+        } else {
+            for (size_t i = 0; i < output.size(); i++) {
+                report.max_abs_error = std::max(report.max_abs_error,
+                    static_cast<double>(std::fabs(output[i] - reference[i])));
+            }
+            if (report.ns_per_sample > 0.0) {
+                report.speedup = reports[0].ns_per_sample / report.ns_per_sample;
+            }
+        }
+        reports.push_back(report);
+    }
+
+    std::cout << "  样本数: " << input_signal.size() << ", 节数: " << design.getNumStages()
+              << ", 重复次数: " << repetitions << std::endl;
+    for (size_t i = 0; i < reports.size(); i++) {
+        std::cout << "  " << std::left << std::setw(32) << reports[i].method << std::right
+                  << std::fixed << std::setprecision(2)
+                  << " " << reports[i].ns_per_sample << " ns/样本"
+                  << ", 加速比: " << reports[i].speedup << "x"
+                  << std::scientific
+                  << ", 最大误差: " << reports[i].max_abs_error << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+
+    return reports;
+}
+
+// ===================== 非规格化数浸泡测试 =====================
+
+namespace {
+
+const int kSoakBlockSize = 256;
+
+struct SoakTiming {
+    double active_ns;
+    double idle_ns;
+    std::vector<double> active_block_ns;
+    std::vector<double> idle_block_ns;
+    int subnormal_states;
+};
+
+// 按块处理并计时，块大小与实时路径的典型缓冲区相当
+template<class Policy>
+SoakTiming run_soak(const BenchmarkDesign& design, std::vector<float> data, size_t active_samples) {
+    typename BenchmarkDesign::template State<Dsp::DirectFormII, Policy> state;
+    SoakTiming timing = { 0.0, 0.0, std::vector<double>(), std::vector<double>(), 0 };
+
+    for (size_t start = 0; start < data.size(); start += kSoakBlockSize) {
+        const int n = static_cast<int>(std::min<size_t>(kSoakBlockSize, data.size() - start));
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        design.process(n, data.data() + start, state);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (start < active_samples) {
+            timing.active_ns += ns;
+            timing.active_block_ns.push_back(ns);
+        } else {
+            timing.idle_ns += ns;
+            timing.idle_block_ns.push_back(ns);
+        }
+    }
+
+    double values[2 * 5];
+    state.getState(values, design);
+    for (int i = 0; i < 2 * design.getNumStages(); i++) {
+        if (std::fpclassify(values[i]) == FP_SUBNORMAL) {
+            timing.subnormal_states++;
+        }
+    }
+    return timing;
+}
+
+// 块耗时的分位数（会重排 blocks）
+double block_percentile(std::vector<double>& blocks, double fraction) {
+    if (blocks.empty()) {
+        return 0.0;
+    }
+    const size_t k = std::min(blocks.size() - 1, static_cast<size_t>(fraction * blocks.size()));
+    std::nth_element(blocks.begin(), blocks.begin() + k, blocks.end());
+    return blocks[k];
+}
+
+typedef SoakTiming (*SoakFunction)(const BenchmarkDesign&, std::vector<float>, size_t);
+
+struct SoakPolicy {
+    const char* name;
+    SoakFunction function;
+    bool realtime_policy;
+};
+
+} // namespace
+
+std::vector<DenormalSoakReport> benchmark_denormal_soak(
+    double low_freq,
+    double high_freq,
+    double sample_rate,
+    int filter_order,
+    double idle_seconds
+) {
+    std::cout << "\n【非规格化数浸泡测试】" << std::endl;
+
+    BenchmarkDesign design;
+    BandPassDesignPtr cached = FilterDesignCache::instance().get_bandpass(
+        low_freq, high_freq, sample_rate, filter_order);
+    if (cached->num_stages() > 5) {
+        throw std::invalid_argument("benchmark_denormal_soak: 节数超过5");
+    }
+    design.setStages(cached->stages.data(), cached->num_stages());
+
+    // 10秒合成脉搏波（1.2Hz基波+二次谐波，叠加在ADC直流上）
+    const double kPi = 3.14159265358979323846;
+    const double kAdcLevel = 2000.0;
+    const size_t active_samples = static_cast<size_t>(10.0 * sample_rate);
+    const size_t idle_samples = static_cast<size_t>(std::max(0.0, idle_seconds) * sample_rate);
+    std::vector<float> active(active_samples);
+    for (size_t i = 0; i < active_samples; i++) {
+        const double t = i / sample_rate;
+        active[i] = static_cast<float>(kAdcLevel + 100.0 * std::sin(2.0 * kPi * 1.2 * t) +
+                                       30.0 * std::sin(2.0 * kPi * 2.4 * t));
+    }
+
+    const SoakPolicy policies[] = {
+        { "vsa注入 (DenormalInjection)",   &run_soak<Dsp::DenormalInjection>,   false },
+        { "FTZ/DAZ (DenormalFlushToZero)", &run_soak<Dsp::DenormalFlushToZero>, false },
+        { "不处理 (DenormalIgnore)",       &run_soak<Dsp::DenormalIgnore>,      false },
+        { "实时策略 (DenormalRealtime)",   &run_soak<Dsp::DenormalRealtime>,    true },
+    };
+    const char* idle_kinds[] = { "静默", "平线" };
+
+    std::vector<DenormalSoakReport> reports;
+    for (int kind = 0; kind < 2; kind++) {
+        std::vector<float> input(active);
+        input.resize(active_samples + idle_samples, kind == 0 ? 0.0f : static_cast<float>(kAdcLevel));
+
+        for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+            SoakTiming timing = policies[p].function(design, input, active_samples);
+
+            // 用99分位而不是最大值，单次线程切换不算作尖峰
+            const double median = block_percentile(timing.active_block_ns, 0.5);
+            const double slow_idle = block_percentile(timing.idle_block_ns, 0.99);
+
+            DenormalSoakReport report;
+            report.policy = policies[p].name;
+            report.idle_kind = idle_kinds[kind];
+            report.ns_per_sample_active = active_samples ? timing.active_ns / active_samples : 0.0;
+            report.ns_per_sample_idle = idle_samples ? timing.idle_ns / idle_samples : 0.0;
+            report.slow_block_ratio = median > 0.0 ? slow_idle / median : 0.0;
+            report.subnormal_states = timing.subnormal_states;
+            report.realtime_policy = policies[p].realtime_policy;
+            reports.push_back(report);
+        }
+    }
+
+    std::cout << "  空闲段: " << idle_seconds << " 秒, 块大小: " << kSoakBlockSize
+              << ", 节数: " << design.getNumStages() << std::endl;
+    for (size_t i = 0; i < reports.size(); i++) {
+        std::cout << "  [" << reports[i].idle_kind << "] " << std::left << std::setw(32)
+                  << reports[i].policy << std::right << std::fixed << std::setprecision(2)
+                  << " 信号段: " << reports[i].ns_per_sample_active << " ns/样本"
+                  << ", 空闲段: " << reports[i].ns_per_sample_idle << " ns/样本"
+                  << ", 空闲段P99块/信号段中位块: " << reports[i].slow_block_ratio << "x"
+                  << ", 非规格化状态: " << reports[i].subnormal_states << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+
+    return reports;
+}
+
 } // namespace ppg
 
@@ -0,0 +1,192 @@
+#include "streaming_filtfilt.hpp"
+#include "DspFilters/Dsp.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace ppg {
+
+namespace {
+
+typedef Dsp::Butterworth::BandPass<5> StreamingDesign;
+typedef StreamingDesign::State<Dsp::TransposedDirectFormII> StreamingState;
+
+// 读取至多 n 个样本，返回实际读取的个数
+size_t read_samples(std::istream& in, float* dest, size_t n) {
+    size_t count = 0;
+    while (count < n && in >> dest[count]) {
+        count++;
+    }
+    return count;
+}
+
+void read_spill(std::fstream& spill, size_t start, float* dest, size_t n) {
+    spill.seekg(static_cast<std::streamoff>(start * sizeof(float)));
+    spill.read(reinterpret_cast<char*>(dest), static_cast<std::streamsize>(n * sizeof(float)));
+    if (!spill) {
+        throw std::runtime_error("apply_bandpass_zerophase_file: 读取溢出文件失败");
+    }
+}
+
+void write_spill(std::fstream& spill, size_t start, const float* src, size_t n) {
+    spill.seekp(static_cast<std::streamoff>(start * sizeof(float)));
+    spill.write(reinterpret_cast<const char*>(src), static_cast<std::streamsize>(n * sizeof(float)));
+    if (!spill) {
+        throw std::runtime_error("apply_bandpass_zerophase_file: 写入溢出文件失败");
+    }
+}
+
+/**
+ * @brief 溢出文件：打开时截断创建，析构时关闭并删除
+ *
+ * 包括读写失败抛出异常在内的任何退出路径都不会在输出文件旁留下溢出文件。
+ * 打开失败时不删除（同名文件不是本次创建的）。
+ */
+class SpillFile {
+public:
+    explicit SpillFile(const std::string& path)
+        : path_(path),
+          stream_(path.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc),
+          created_(stream_.is_open()) {}
+
+    ~SpillFile() {
+        if (created_) {
+            stream_.close();
+            std::remove(path_.c_str());
+        }
+    }
+
+    bool is_open() const { return created_; }
+    std::fstream& stream() { return stream_; }
+
+private:
+    SpillFile(const SpillFile&);
+    SpillFile& operator=(const SpillFile&);
+
+    std::string path_;
+    std::fstream stream_;
+    bool created_;
+};
+
+} // namespace
+
+size_t apply_bandpass_zerophase_file(
+    const std::string& input_path,
+    const std::string& output_path,
+    const BandPassSpec& spec,
+    size_t chunk_samples,
+    int precision
+) {
+    std::cout << "\n【零相位滤波（分块落盘）】" << std::endl;
+
+    StreamingDesign filter;
+    BandPassDesignPtr design = FilterDesignCache::instance().get_bandpass(spec);
+    if (design->num_stages() > StreamingDesign::MaxStages) {
+        throw std::invalid_argument("apply_bandpass_zerophase_file: 设计的节数超出范围");
+    }
+    filter.setStages(design->stages.data(), design->num_stages());
+
+    // 与 filtfilt 默认值相同的奇对称延拓
+    const size_t padlen = static_cast<size_t>(3 * (2 * filter.getNumStages() + 1));
+
+    // 块长取分块递推tile的整数倍，使块边界与内存版本的tile边界重合
+    const size_t tile = Dsp::Cascade::BlockTileSize;
+    chunk_samples = std::max(tile, (chunk_samples + tile - 1) / tile * tile);
+
+    std::ifstream infile(input_path);
+    if (!infile.is_open()) {
+        std::cerr << "错误：无法打开文件 " << input_path << std::endl;
+        return 0;
+    }
+    const std::string spill_path = output_path + ".spill";
+    SpillFile spill_file(spill_path);
+    if (!spill_file.is_open()) {
+        std::cerr << "错误：无法创建溢出文件 " << spill_path << std::endl;
+        return 0;
+    }
+    std::fstream& spill = spill_file.stream();
+
+    std::vector<float> buffer(chunk_samples);
+    std::vector<float> recent;                  // 最后 padlen+1 个原始样本
+    std::vector<float> tail(padlen);
+    StreamingState state;
+
+    size_t n = read_samples(infile, buffer.data(), chunk_samples);
+    if (n <= padlen) {
+        throw std::invalid_argument("apply_bandpass_zerophase_file: 信号长度必须大于padlen");
+    }
+
+    // 第一遍：正向滤波。头部延拓段只需要首块的前 padlen+1 个样本
+    const float first = buffer[0];
+    state.setSteadyState(2.0f * first - buffer[padlen], filter);
+    for (size_t k = 0; k < padlen; k++) {
+        state.process(2.0f * first - buffer[padlen - k], filter);
+    }
+
+    size_t total = 0;
+    while (n > 0) {
+        recent.insert(recent.end(), buffer.begin() + (n > padlen + 1 ? n - padlen - 1 : 0),
+                      buffer.begin() + n);
+        if (recent.size() > padlen + 1) {
+            recent.erase(recent.begin(), recent.end() - (padlen + 1));
+        }
+
+        state.processBlock(static_cast<int>(n), buffer.data(), filter);
+        write_spill(spill, total, buffer.data(), n);
+        total += n;
+
+        if (n < chunk_samples) {
+            break;
+        }
+        n = read_samples(infile, buffer.data(), chunk_samples);
+    }
+    infile.close();
+
+    // 尾部延拓段：recent[padlen] 为最后一个样本，recent[padlen-1-j] 即 x[n-2-j]
+    const float last = recent[padlen];
+    for (size_t j = 0; j < padlen; j++) {
+        tail[j] = 2.0f * last - recent[padlen - 1 - j];
+    }
+    state.processBlock(static_cast<int>(padlen), tail.data(), filter);
+
+    // 第二遍：反向滤波，块从记录末尾对齐，倒序读回并原地写回
+    state.reset();
+    state.setSteadyState(tail[padlen - 1], filter);
+    state.processBlock(static_cast<int>(padlen), tail.data() + padlen - 1, filter, -1);
+    for (size_t end = total; end > 0;) {
+        const size_t len = std::min(chunk_samples, end);
+        const size_t start = end - len;
+        read_spill(spill, start, buffer.data(), len);
+        state.processBlock(static_cast<int>(len), buffer.data() + len - 1, filter, -1);
+        write_spill(spill, start, buffer.data(), len);
+        end = start;
+    }
+
+    // 顺序写出文本结果（格式与 save_signal_to_file 一致）
+    std::ofstream outFile(output_path);
+    if (!outFile.is_open()) {
+        std::cerr << "错误：无法打开文件 " << output_path << std::endl;
+        return 0;
+    }
+    outFile << std::fixed << std::setprecision(precision);
+    for (size_t start = 0; start < total; start += chunk_samples) {
+        const size_t len = std::min(chunk_samples, total - start);
+        read_spill(spill, start, buffer.data(), len);
+        for (size_t i = 0; i < len; i++) {
+            outFile << buffer[i] << '\n';
+        }
+    }
+    outFile.close();
+
+    std::cout << "  样本数: " << total << ", 块大小: " << chunk_samples
+              << " (缓冲区 " << chunk_samples * sizeof(float) / 1024 << " KB)" << std::endl;
+    std::cout << "  结果已保存到: " << output_path << std::endl;
+
+    return total;
+}
+
+} // namespace ppg
@@ -0,0 +1,383 @@
+#include "streaming_peak_detector.hpp"
+#include "find_peaks.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ppg
+{
+
+    namespace
+    {
+        int resolve_max_delay(int distance, int wlen, int max_delay)
+        {
+            if (max_delay <= 0)
+            {
+                return 4 * std::max(std::max(distance, wlen), 1);
+            }
+            if (max_delay < distance)
+            {
+                throw std::invalid_argument("StreamingPeakDetector: 最大确认延迟不能小于distance");
+            }
+            return max_delay;
+        }
+    } // namespace
+
+    // ===================== 单一极性的检测状态 =====================
+
+    StreamingPeakDetector::Tracker::Tracker(float sign, int distance, float min_height,
+                                            float min_prominence, int wlen, int max_delay)
+        : sign_(sign), distance_(distance), min_height_(min_height),
+          min_prominence_(min_prominence),
+          half_window_(wlen >= 2 ? static_cast<size_t>(wlen / 2) : 0),
+          max_delay_(max_delay)
+    {
+        reset();
+    }
+
+    void StreamingPeakDetector::Tracker::reset()
+    {
+        candidates_.clear();
+        front_sequence_ = 0;
+        undecided_sequence_ = 0;
+        window_.clear();
+        left_.clear();
+        right_.clear();
+        dominance_.clear();
+        has_kept_ = false;
+        last_kept_ = 0;
+        forced_ = 0;
+        confirmed_.clear();
+    }
+
+    StreamingPeakDetector::Tracker::Candidate *StreamingPeakDetector::Tracker::find(size_t sequence)
+    {
+        if (sequence < front_sequence_)
+        {
+            return nullptr; // 已输出或已丢弃
+        }
+        return &candidates_[sequence - front_sequence_];
+    }
+
+    void StreamingPeakDetector::Tracker::decide_prominence(const RightEntry &entry, float right_min)
+    {
+        Candidate *candidate = find(entry.sequence);
+        if (candidate && candidate->prominence_state == Pending)
+        {
+            // 与 calculate_prominences 相同的表达式，保证逐位一致
+            const float prominence = entry.height - std::max(entry.left_min, right_min);
+            candidate->prominence_state = (prominence >= min_prominence_) ? Passed : Failed;
+        }
+    }
+
+    void StreamingPeakDetector::Tracker::close_segment()
+    {
+        const size_t end = front_sequence_ + candidates_.size();
+        if (distance_ <= 1 || undecided_sequence_ >= end)
+        {
+            return;
+        }
+
+        // 段长受 max_delay 约束，位置相对段首存放，不会溢出 int
+        const size_t origin = find(undecided_sequence_)->position;
+        segment_positions_.clear();
+        segment_heights_.clear();
+        for (size_t s = undecided_sequence_; s < end; s++)
+        {
+            const Candidate *candidate = find(s);
+            segment_positions_.push_back(static_cast<int>(candidate->position - origin));
+            segment_heights_.push_back(candidate->height);
+        }
+        select_by_peak_distance(segment_positions_, segment_heights_, distance_, segment_keep_);
+
+        for (size_t s = undecided_sequence_; s < end; s++)
+        {
+            Candidate *candidate = find(s);
+            if (segment_keep_[s - undecided_sequence_])
+            {
+                candidate->distance_state = Kept;
+                has_kept_ = true;
+                last_kept_ = candidate->position;
+            }
+            else
+            {
+                candidate->distance_state = Removed;
+            }
+        }
+        undecided_sequence_ = end;
+        dominance_.clear();
+    }
+
+    void StreamingPeakDetector::Tracker::emit(size_t i, bool at_end)
+    {
+        while (!candidates_.empty())
+        {
+            Candidate &front = candidates_.front();
+            // 距离未决的候选仍参与段内贪心，不能提前丢弃；已被距离删除的不必等显著性
+            if (front.distance_state == Undecided ||
+                (front.distance_state == Kept && front.prominence_state == Pending))
+            {
+                // 样本 i 在样本 i+1 到达时处理，故 i+1-position 即已等待的样本数
+                if (at_end || i + 1 - front.position < static_cast<size_t>(max_delay_))
+                {
+                    break;
+                }
+                forced_++;
+                if (front.distance_state == Undecided)
+                {
+                    close_segment();
+                }
+                if (front.prominence_state == Pending)
+                {
+                    // 尚未满足阈值：当前显著性小于 min_prominence
+                    front.prominence_state = Failed;
+                }
+            }
+
+            if (front.distance_state == Kept && front.prominence_state == Passed)
+            {
+                ConfirmedExtremum extremum = {front.position, sign_ * front.height};
+                confirmed_.push_back(extremum);
+            }
+            candidates_.pop_front();
+            front_sequence_++;
+        }
+    }
+
+    void StreamingPeakDetector::Tracker::step(size_t i, float x, bool is_local_max)
+    {
+        const bool use_prominence = (min_prominence_ >= 0.0f);
+
+        // 1. 滑动窗口最小值，覆盖 [i - half_window, i]
+        if (half_window_ > 0)
+        {
+            while (!window_.empty() && window_.back().value >= x)
+            {
+                window_.pop_back();
+            }
+            Sample sample = {i, x};
+            window_.push_back(sample);
+            while (i - window_.front().position > half_window_)
+            {
+                window_.pop_front();
+            }
+        }
+
+        float left_min = x;
+        if (use_prominence)
+        {
+            // 2. 右侧搜索：x 严格高于栈顶候选时，其搜索在 x 之前结束
+            while (!right_.empty() && right_.back().height < x)
+            {
+                const RightEntry entry = right_.back();
+                right_.pop_back();
+                decide_prominence(entry, std::min(entry.height, entry.segment_min));
+                if (!right_.empty())
+                {
+                    RightEntry &below = right_.back();
+                    below.segment_min = std::min(below.segment_min,
+                                                 std::min(entry.segment_min, entry.height));
+                }
+            }
+            // 搜索到达窗口边缘 position + half_window（栈底最早到期）
+            while (half_window_ > 0 && !right_.empty() && right_.front().position + half_window_ <= i)
+            {
+                decide_prominence(right_.front(), window_.front().value);
+                right_.pop_front();
+            }
+            if (!right_.empty())
+            {
+                right_.back().segment_min = std::min(right_.back().segment_min, x);
+            }
+
+            // 3. 左侧搜索：合并所有不高于 x 的栈顶区间
+            LeftEntry entry = {i, x, x};
+            while (!left_.empty() && left_.back().value <= x)
+            {
+                entry.min_value = std::min(entry.min_value, left_.back().min_value);
+                left_.pop_back();
+            }
+            const size_t reach = left_.empty() ? i : i - left_.back().position - 1;
+            left_.push_back(entry);
+            if (half_window_ > 0)
+            {
+                // 距离超过 half_window+1 的项只会让 reach 超过窗口，可以丢弃
+                while (left_.front().position + half_window_ + 1 < i)
+                {
+                    left_.pop_front();
+                }
+            }
+            left_min = (half_window_ > 0 && half_window_ < reach) ? window_.front().value
+                                                                 : entry.min_value;
+        }
+
+        // 4. 新候选
+        const bool passes_height = !std::isfinite(min_height_) || x >= min_height_;
+        const bool too_close = distance_ > 1 && has_kept_ &&
+                               i - last_kept_ < static_cast<size_t>(distance_);
+        if (is_local_max && passes_height && !too_close)
+        {
+            const size_t sequence = front_sequence_ + candidates_.size();
+            Candidate candidate = {i, x, Undecided, Passed};
+
+            if (use_prominence)
+            {
+                // 显著性只会随右侧搜索增大，左侧已不够时直接判定
+                if (x - left_min < min_prominence_)
+                {
+                    candidate.prominence_state = Failed;
+                }
+                else
+                {
+                    candidate.prominence_state = Pending;
+                    RightEntry entry = {i, x, left_min, std::numeric_limits<float>::infinity(), sequence};
+                    right_.push_back(entry);
+                }
+            }
+
+            if (distance_ > 1)
+            {
+                while (!dominance_.empty() &&
+                       i - dominance_.front().position >= static_cast<size_t>(distance_))
+                {
+                    dominance_.pop_front();
+                }
+                // 等高时靠右者优先
+                while (!dominance_.empty() && dominance_.back().height <= x)
+                {
+                    dominance_.pop_back();
+                }
+                DominanceEntry entry = {i, x, dominance_.empty()};
+                dominance_.push_back(entry);
+            }
+            else
+            {
+                candidate.distance_state = Kept;
+            }
+            candidates_.push_back(candidate);
+        }
+
+        // 5. 右侧最小值已足够低：h - max(left_min, x) >= min_prominence 时显著性必然达标；
+        //    栈中高度自底向上不增，满足条件的是栈底的一段
+        if (use_prominence)
+        {
+            while (!right_.empty() && right_.front().height - x >= min_prominence_)
+            {
+                decide_prominence(right_.front(), x);
+                right_.pop_front();
+            }
+        }
+
+        // 6. 距离约束分段：间隙或支配峰之前的候选与之后的候选互不影响
+        if (distance_ > 1 && undecided_sequence_ < front_sequence_ + candidates_.size())
+        {
+            const size_t window_end = static_cast<size_t>(distance_ - 1);
+            const bool gap = i >= candidates_.back().position + window_end;
+            const bool dominant = !dominance_.empty() && dominance_.front().left_dominant &&
+                                  i >= dominance_.front().position + window_end;
+            if (gap || dominant)
+            {
+                close_segment();
+            }
+        }
+
+        emit(i, false);
+    }
+
+    void StreamingPeakDetector::Tracker::finish()
+    {
+        // 信号结束：仍在搜索的候选的右侧范围截止到最后一个样本
+        float suffix_min = std::numeric_limits<float>::infinity();
+        while (!right_.empty())
+        {
+            const RightEntry entry = right_.back();
+            right_.pop_back();
+            suffix_min = std::min(suffix_min, entry.segment_min);
+            decide_prominence(entry, std::min(entry.height, suffix_min));
+            suffix_min = std::min(suffix_min, entry.height);
+        }
+        close_segment();
+        emit(0, true);
+    }
+
+    size_t StreamingPeakDetector::Tracker::take(std::vector<ConfirmedExtremum> &out)
+    {
+        const size_t count = confirmed_.size();
+        out.insert(out.end(), confirmed_.begin(), confirmed_.end());
+        confirmed_.clear();
+        return count;
+    }
+
+    // ===================== 检测器 =====================
+
+    StreamingPeakDetector::StreamingPeakDetector(int distance, float min_height,
+                                                 float min_prominence, int wlen, int max_delay)
+        : max_delay_(resolve_max_delay(distance, wlen, max_delay)),
+          peaks_(1.0f, distance, min_height, min_prominence, wlen, max_delay_),
+          valleys_(-1.0f, distance, min_height, min_prominence, wlen, max_delay_),
+          received_(0), previous_(0.0f), current_(0.0f)
+    {
+    }
+
+    void StreamingPeakDetector::process_sample(float input)
+    {
+        // 局部极值需要右侧样本，样本 i 在样本 i+1 到达时处理
+        if (received_ > 0)
+        {
+            const size_t i = received_ - 1;
+            const bool has_left = (i > 0);
+            peaks_.step(i, current_,
+                        has_left && previous_ < current_ && current_ >= input);
+            valleys_.step(i, -current_,
+                          has_left && -previous_ < -current_ && -current_ >= -input);
+        }
+        previous_ = current_;
+        current_ = input;
+        received_++;
+    }
+
+    void StreamingPeakDetector::process_block(const float *in, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            process_sample(in[i]);
+        }
+    }
+
+    void StreamingPeakDetector::flush()
+    {
+        // 最后一个样本没有右侧样本，不是局部极值
+        if (received_ > 0)
+        {
+            peaks_.step(received_ - 1, current_, false);
+            valleys_.step(received_ - 1, -current_, false);
+        }
+        peaks_.finish();
+        valleys_.finish();
+    }
+
+    void StreamingPeakDetector::reset()
+    {
+        peaks_.reset();
+        valleys_.reset();
+        received_ = 0;
+        previous_ = 0.0f;
+        current_ = 0.0f;
+    }
+
+    size_t StreamingPeakDetector::take_peaks(std::vector<ConfirmedExtremum> &out)
+    {
+        return peaks_.take(out);
+    }
+
+    size_t StreamingPeakDetector::take_valleys(std::vector<ConfirmedExtremum> &out)
+    {
+        return valleys_.take(out);
+    }
+
+    size_t StreamingPeakDetector::forced_decisions() const
+    {
+        return peaks_.forced() + valleys_.forced();
+    }
+
+} // namespace ppg
@@ -0,0 +1,149 @@
+#include "ppg_filters.hpp"
+#include "realtime_filter.hpp"
+#include "test_utils.hpp"
+#include "DspFilters/Dsp.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// =====================================================================
+// 非规格化数浸泡：实时路径在长时间静默/平线后不得出现CPU尖峰
+// =====================================================================
+
+namespace {
+
+// 空闲段块耗时99分位 / 有信号段块耗时中位数 的上限。出现非规格化数时
+// 该比值在 9x（双通道平线）到 100x（静默）之间，正常波动在 1.5x 以内
+const double kMaxSlowBlockRatio = 4.0;
+
+const double kSampleRate = 1000.0;
+const double kLowFreq = 0.5;
+const double kHighFreq = 20.0;
+const int kFilterOrder = 3;
+const double kIdleSeconds = 900.0; // 最慢的极点衰减到非规格化范围约需4分钟
+const size_t kBlockSize = 256;
+const float kAdcLevel = 2000.0f;
+
+/**
+ * @brief 10秒合成脉搏波，之后是空闲段（静默为全零，平线为恒定ADC值）
+ */
+std::vector<float> soak_input(bool flat_line, size_t& active_samples) {
+    active_samples = static_cast<size_t>(10.0 * kSampleRate);
+    const size_t idle_samples = static_cast<size_t>(kIdleSeconds * kSampleRate);
+    std::vector<float> input(active_samples + idle_samples, flat_line ? kAdcLevel : 0.0f);
+    for (size_t i = 0; i < active_samples; i++) {
+        const double t = i / kSampleRate;
+        input[i] = static_cast<float>(kAdcLevel + 100.0 * std::sin(2.0 * M_PI * 1.2 * t) +
+                                      30.0 * std::sin(2.0 * M_PI * 2.4 * t));
+    }
+    return input;
+}
+
+double percentile(std::vector<double> blocks, double fraction) {
+    if (blocks.empty()) {
+        return 0.0;
+    }
+    const size_t k = std::min(blocks.size() - 1, static_cast<size_t>(fraction * blocks.size()));
+    std::nth_element(blocks.begin(), blocks.begin() + k, blocks.end());
+    return blocks[k];
+}
+
+/**
+ * @brief 按块处理整段输入并计时，返回空闲段P99块 / 信号段中位块
+ *
+ * process(data, n) 原地处理一个块。
+ */
+template<class Process>
+double slow_block_ratio(const std::vector<float>& input, size_t active_samples, Process process) {
+    std::vector<float> data(input);
+    std::vector<double> active_blocks;
+    std::vector<double> idle_blocks;
+    for (size_t start = 0; start < data.size(); start += kBlockSize) {
+        const size_t n = std::min(kBlockSize, data.size() - start);
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        process(data.data() + start, n);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        (start < active_samples ? active_blocks : idle_blocks).push_back(ns);
+    }
+    const double median = percentile(active_blocks, 0.5);
+    return median > 0.0 ? percentile(idle_blocks, 0.99) / median : 0.0;
+}
+
+} // namespace
+
+static void test_benchmark_realtime_policy() {
+    const std::vector<ppg::DenormalSoakReport> reports = ppg::benchmark_denormal_soak(
+        kLowFreq, kHighFreq, kSampleRate, kFilterOrder, kIdleSeconds);
+
+    int checked = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (!reports[i].realtime_policy) {
+            continue;
+        }
+        checked++;
+        TEST_CHECK(reports[i].slow_block_ratio <= kMaxSlowBlockRatio,
+                   "[" << reports[i].idle_kind << "] 实时策略空闲段P99块耗时为信号段中位数的 "
+                   << reports[i].slow_block_ratio << " 倍，上限 " << kMaxSlowBlockRatio);
+#ifdef DSPFILTERS_HAVE_MXCSR
+        // 无MXCSR的平台只能注入，平线下后级状态仍可能非规格化，只检查耗时
+        TEST_CHECK(reports[i].subnormal_states == 0,
+                   "[" << reports[i].idle_kind << "] 实时策略结束时有 "
+                   << reports[i].subnormal_states << " 个非规格化状态");
+#endif
+    }
+    TEST_CHECK(checked == 2, "浸泡报告应包含静默与平线两种实时策略结果");
+}
+
+static void test_realtime_filters() {
+    const ppg::BandPassSpec spec(kLowFreq, kHighFreq, kSampleRate, kFilterOrder);
+    const char* idle_kinds[] = { "静默", "平线" };
+
+    for (int kind = 0; kind < 2; kind++) {
+        size_t active_samples = 0;
+        const std::vector<float> input = soak_input(kind == 1, active_samples);
+
+        // RealtimeFilter 块路径（CascadeKernel::process_block）
+        ppg::RealtimeFilter block_filter(spec);
+        const double block_ratio = slow_block_ratio(input, active_samples,
+            [&](float* data, size_t n) { block_filter.process_block(data, n); });
+        TEST_CHECK(block_ratio <= kMaxSlowBlockRatio,
+                   "[" << idle_kinds[kind] << "] RealtimeFilter::process_block 空闲段慢 "
+                   << block_ratio << " 倍");
+
+        // RealtimeFilter 逐样本路径（CascadeKernel::process_sample）
+        ppg::RealtimeFilter sample_filter(spec);
+        const double sample_ratio = slow_block_ratio(input, active_samples,
+            [&](float* data, size_t n) {
+                for (size_t i = 0; i < n; i++) {
+                    data[i] = sample_filter.process_sample(data[i]);
+                }
+            });
+        TEST_CHECK(sample_ratio <= kMaxSlowBlockRatio,
+                   "[" << idle_kinds[kind] << "] RealtimeFilter::process_sample 空闲段慢 "
+                   << sample_ratio << " 倍");
+
+        // MultiChannelRealtimeFilter（lane并行DF-II，realtime_main的双通道路径）
+        ppg::MultiChannelRealtimeFilter multi_filter(2, spec);
+        std::vector<float> second(kBlockSize);
+        const double multi_ratio = slow_block_ratio(input, active_samples,
+            [&](float* data, size_t n) {
+                std::copy(data, data + n, second.begin());
+                float* channels[2] = { data, second.data() };
+                multi_filter.process_block(channels, n);
+            });
+        TEST_CHECK(multi_ratio <= kMaxSlowBlockRatio,
+                   "[" << idle_kinds[kind] << "] MultiChannelRealtimeFilter 空闲段慢 "
+                   << multi_ratio << " 倍");
+
+        std::cout << "  [" << idle_kinds[kind] << "] 空闲段P99块/信号段中位块: 块 "
+                  << block_ratio << "x, 逐样本 " << sample_ratio << "x, 多通道 "
+                  << multi_ratio << "x" << std::endl;
+    }
+}
+
+int main() {
+    test_benchmark_realtime_policy();
+    test_realtime_filters();
+    return test_summary("test_denormal_soak");
+}
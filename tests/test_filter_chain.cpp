@@ -0,0 +1,184 @@
+#include "filter_chain.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// =====================================================================
+// 融合滤波链：各抽头与逐个环节依次滤波一致
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+const double kMainsFrequency = 50.0;
+const double kNotchQ = 30.0;
+
+/**
+ * @brief 参考实现：双精度直接I型biquad（与库中的状态结构无关）
+ *
+ * getB0() 等返回未归一化的系数（RBJ设计的 a0 不为1），这里按 a0 归一化。
+ */
+void biquad_reference(const Dsp::BiquadBase& s, std::vector<double>& x) {
+    const double a0 = s.getA0();
+    double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+    for (size_t i = 0; i < x.size(); i++) {
+        const double y = (s.getB0() * x[i] + s.getB1() * x1 + s.getB2() * x2
+                          - s.getA1() * y1 - s.getA2() * y2) / a0;
+        x2 = x1;
+        x1 = x[i];
+        y2 = y1;
+        y1 = y;
+        x[i] = y;
+    }
+}
+
+/**
+ * @brief 参考实现：中心差分 (x[n] - x[n-2]) * fs / 2，初始状态为零
+ */
+std::vector<double> central_difference(const std::vector<double>& x) {
+    std::vector<double> d(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        const double x2 = (i >= 2) ? x[i - 2] : 0.0;
+        d[i] = (x[i] - x2) * kSampleRate / 2.0;
+    }
+    return d;
+}
+
+/**
+ * @brief 含工频干扰的PPG：直流偏置、脉搏波、50Hz干扰与噪声
+ */
+std::vector<float> ppg_with_mains(std::mt19937& rng, size_t n) {
+    std::normal_distribution<double> noise(0.0, 2.0);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        phase = std::fmod(phase + 1.2 / kSampleRate, 1.0);
+        const double pulse = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        signal[i] = static_cast<float>(1000.0 + 100.0 * pulse +
+                                       30.0 * std::sin(2.0 * M_PI * kMainsFrequency * t) + noise(rng));
+    }
+    return signal;
+}
+
+/**
+ * @brief float结果相对双精度参考的最大误差，以参考的峰值归一化
+ */
+double relative_error(const std::vector<float>& actual, const std::vector<double>& expected) {
+    double max_diff = 0.0;
+    double peak = 0.0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        max_diff = std::max(max_diff, std::fabs(actual[i] - expected[i]));
+        peak = std::max(peak, std::fabs(expected[i]));
+    }
+    return peak > 0.0 ? max_diff / peak : max_diff;
+}
+
+} // namespace
+
+// 输出以float存储，内部全程双精度：允许误差取几个float的ulp（相对峰值）
+static const double kTolerance = 1e-6;
+
+static void test_taps_match_sequential() {
+    std::mt19937 rng(19);
+    // 跨越多个 BlockTileSize 分块，且不是其整数倍
+    const size_t n = 3 * Dsp::Cascade::BlockTileSize + 77;
+    const std::vector<float> input = ppg_with_mains(rng, n);
+
+    // 逐个环节依次滤波的参考：带通 -> RBJ陷波 -> 微分
+    const ppg::BandPassSpec spec(0.5, 20.0, kSampleRate, 3);
+    ppg::BandPassDesignPtr design = ppg::FilterDesignCache::instance().get_bandpass(spec);
+    std::vector<double> bandpassed(input.begin(), input.end());
+    for (int i = 0; i < design->num_stages(); i++) {
+        biquad_reference(design->stages[i], bandpassed);
+    }
+    Dsp::RBJ::BandStop notch;
+    notch.setup(kSampleRate, kMainsFrequency, kNotchQ);
+    std::vector<double> notched = bandpassed;
+    biquad_reference(notch, notched);
+    const std::vector<double> derivative = central_difference(notched);
+
+    for (int mode = 0; mode < 2; mode++) {
+        const bool block = (mode == 1);
+        ppg::FusedFilterChain chain(kSampleRate);
+        chain.add_bandpass(spec);
+        const int bandpass_tap = chain.tap();
+        chain.add_notch(kMainsFrequency, kNotchQ);
+        const int notch_tap = chain.tap();
+        chain.add_derivative();
+        TEST_CHECK(chain.num_stages() == design->num_stages() + 2, "链的节数应为带通节数加2");
+        TEST_CHECK(chain.num_taps() == 2 && bandpass_tap == 0 && notch_tap == 1, "抽头编号应按添加顺序");
+
+        std::vector<float> output = input;
+        std::vector<float> tap_bandpass(n);
+        std::vector<float> tap_notch(n);
+        if (block) {
+            // 分两次调用，且分界不在分块边界上：状态须跨调用连续
+            const size_t split = 700;
+            float* taps[] = { tap_bandpass.data(), tap_notch.data() };
+            chain.process_block(output.data(), split, taps);
+            float* rest[] = { tap_bandpass.data() + split, tap_notch.data() + split };
+            chain.process_block(output.data() + split, n - split, rest);
+        } else {
+            float taps[2];
+            for (size_t i = 0; i < n; i++) {
+                output[i] = chain.process_sample(input[i], taps);
+                tap_bandpass[i] = taps[0];
+                tap_notch[i] = taps[1];
+            }
+        }
+
+        const char* name = block ? "块模式" : "逐样本";
+        const double bandpass_error = relative_error(tap_bandpass, bandpassed);
+        const double notch_error = relative_error(tap_notch, notched);
+        const double output_error = relative_error(output, derivative);
+        TEST_CHECK(bandpass_error <= kTolerance, name << "：带通抽头相对误差 " << bandpass_error);
+        TEST_CHECK(notch_error <= kTolerance, name << "：陷波抽头相对误差 " << notch_error);
+        TEST_CHECK(output_error <= kTolerance, name << "：微分输出相对误差 " << output_error);
+        std::cout << "  " << name << ": 带通 " << bandpass_error << ", 陷波 " << notch_error
+                  << ", 微分 " << output_error << std::endl;
+    }
+}
+
+static void test_differentiator_scale() {
+    // 斜率 3 单位/秒 的斜坡：从第三个样本起输出恒为 3
+    Dsp::CascadeChain<4> chain;
+    chain.appendDifferentiator(kSampleRate);
+    Dsp::CascadeChain<4>::State<Dsp::DirectFormII> state;
+    double ramp_error = 0.0;
+    for (int i = 0; i < 100; i++) {
+        const double out = state.process(3.0 * i / kSampleRate, chain);
+        if (i >= 2) {
+            ramp_error = std::max(ramp_error, std::fabs(out - 3.0));
+        }
+    }
+    TEST_CHECK(ramp_error <= 1e-9, "斜坡的微分应为 3 单位/秒，最大偏差 " << ramp_error);
+
+    // 正弦 A*sin(w n)：中心差分为 A*fs*sin(w)*cos(w(n-1))，低频时趋于解析导数 A*2*pi*f
+    const double frequency = 5.0;
+    const double amplitude = 2.0;
+    const double w = 2.0 * M_PI * frequency / kSampleRate;
+    ppg::FusedFilterChain fused(kSampleRate);
+    fused.add_derivative();
+    std::vector<float> sine(1000);
+    for (size_t i = 0; i < sine.size(); i++) {
+        sine[i] = static_cast<float>(amplitude * std::sin(w * i));
+    }
+    std::vector<float> block = sine;
+    fused.process_block(block.data(), block.size());
+    double sine_error = 0.0;
+    for (size_t i = 2; i < block.size(); i++) {
+        const double expected = amplitude * kSampleRate * std::sin(w) * std::cos(w * (i - 1.0));
+        sine_error = std::max(sine_error, std::fabs(block[i] - expected));
+    }
+    // 输入以float存储，差分放大 fs/2 倍：误差上限取 fs * A 处的float舍入
+    const double sine_tolerance = 4.0 * kSampleRate * amplitude * std::numeric_limits<float>::epsilon();
+    TEST_CHECK(sine_error <= sine_tolerance, "正弦的微分与中心差分公式最大相差 " << sine_error);
+}
+
+int main() {
+    test_taps_match_sequential();
+    test_differentiator_scale();
+    return test_summary("test_filter_chain");
+}
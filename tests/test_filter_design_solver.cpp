@@ -0,0 +1,168 @@
+#include "filter_design_solver.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// =====================================================================
+// 最小代价带通设计：结果满足指标，且少一阶时任何族都不满足
+// =====================================================================
+
+namespace {
+
+// 检验网格比求解器的网格密16倍，纹波峰与阻带旁瓣落在求解器网格点之间时也能发现
+const int kGridPoints = 4096;
+
+struct Measured {
+    double ripple_db;
+    double atten_db;
+};
+
+/**
+ * @brief 把设计的各节装入 Dsp::Cascade，在密集网格上用 Cascade::response 实测指标
+ */
+Measured measure(const ppg::BandPassDesign& design, const ppg::BandPassRequirements& req) {
+    Dsp::CascadeChain<ppg::FilterDesignCache::kMaxOrder> cascade;
+    for (int i = 0; i < design.num_stages(); i++) {
+        cascade.append(design.stages[i]);
+    }
+
+    double pass_max = 0.0;
+    double pass_min = 1e300;
+    double stop_max = 0.0;
+    for (int i = 0; i <= kGridPoints; i++) {
+        const double f = 0.5 * req.sample_rate * i / kGridPoints;
+        const double gain = std::abs(cascade.response(f / req.sample_rate));
+        if (f >= req.pass_low && f <= req.pass_high) {
+            pass_max = std::max(pass_max, gain);
+            pass_min = std::min(pass_min, gain);
+        }
+        if (f <= req.stop_low || f >= req.stop_high) {
+            stop_max = std::max(stop_max, gain);
+        }
+    }
+    Measured m;
+    m.ripple_db = 20.0 * std::log10(pass_max / pass_min);
+    m.atten_db = 20.0 * std::log10(pass_max / stop_max);
+    return m;
+}
+
+bool meets_spec(const ppg::BandPassDesign& design, const ppg::BandPassRequirements& req) {
+    const Measured m = measure(design, req);
+    return m.ripple_db <= req.passband_ripple_db && m.atten_db >= req.stopband_atten_db;
+}
+
+/**
+ * @brief 按求解器的扫描方式（设计边缘 21 点、Elliptic 陡度 -2 ~ 2）枚举某族某阶的候选，
+ *        返回是否有候选在密集网格上满足指标
+ */
+bool any_candidate_meets(const ppg::BandPassRequirements& req, ppg::FilterFamily family,
+                         int order, bool sweep_rolloff) {
+    const int edge_steps = 20;
+    const double rolloffs[] = { -2.0, -1.0, 0.0, 1.0, 2.0 };
+    const bool elliptic = (family == ppg::FilterFamily::Elliptic);
+    const int num_rolloffs = (elliptic && sweep_rolloff) ? 5 : 1;
+    for (int r = 0; r < num_rolloffs; r++) {
+        for (int step = 0; step <= edge_steps; step++) {
+            const double t = static_cast<double>(step) / edge_steps;
+            ppg::BandPassSpec spec(req.pass_low + t * (req.stop_low - req.pass_low),
+                                   req.pass_high + t * (req.stop_high - req.pass_high),
+                                   req.sample_rate, order, family);
+            spec.ripple_db = 0.95 * req.passband_ripple_db;
+            spec.stopband_db = req.stopband_atten_db;
+            spec.rolloff = (elliptic && sweep_rolloff) ? rolloffs[r] : 0.0;
+            if (meets_spec(*ppg::design_bandpass(spec), req)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+static void test_solution_is_minimal() {
+    const ppg::FilterFamily families[] = {
+        ppg::FilterFamily::Butterworth, ppg::FilterFamily::ChebyshevI,
+        ppg::FilterFamily::ChebyshevII, ppg::FilterFamily::Elliptic
+    };
+    const ppg::BandPassRequirements cases[] = {
+        ppg::BandPassRequirements(0.5, 8.0, 0.2, 15.0, 100.0, 1.0, 40.0),
+        ppg::BandPassRequirements(0.5, 20.0, 0.1, 40.0, 1000.0, 1.0, 40.0),
+        ppg::BandPassRequirements(0.5, 8.0, 0.3, 10.0, 100.0, 0.5, 40.0),
+        ppg::BandPassRequirements(0.7, 3.5, 0.4, 4.0, 25.0, 0.2, 40.0)
+    };
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const ppg::BandPassRequirements& req = cases[c];
+        const ppg::BandPassSolution solution = ppg::design_min_cost_bandpass(req);
+        const int order = solution.spec.order;
+
+        // 返回的设计在密集网格上满足指标（等纹波族按 0.95 倍纹波设计，网格间的峰不越界）
+        const Measured m = measure(*solution.design, req);
+        TEST_CHECK(m.ripple_db <= req.passband_ripple_db,
+                   "用例 " << c << "：实测通带起伏 " << m.ripple_db << " dB 超过 "
+                   << req.passband_ripple_db << " dB");
+        TEST_CHECK(m.atten_db >= req.stopband_atten_db,
+                   "用例 " << c << "：实测阻带衰减 " << m.atten_db << " dB 低于 "
+                   << req.stopband_atten_db << " dB");
+        TEST_CHECK(solution.num_stages == solution.design->num_stages() && solution.num_stages == order,
+                   "用例 " << c << "：节数 " << solution.num_stages << " 与设计不一致");
+        if (solution.spec.family == ppg::FilterFamily::ChebyshevI ||
+            solution.spec.family == ppg::FilterFamily::Elliptic) {
+            TEST_CHECK(std::fabs(solution.spec.ripple_db - 0.95 * req.passband_ripple_db) < 1e-12,
+                       "用例 " << c << "：等纹波族应按 0.95 倍的允许纹波设计");
+        }
+
+        // 少一阶时四个族的所有候选都不满足指标
+        if (order > 1) {
+            for (size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++) {
+                TEST_CHECK(!any_candidate_meets(req, families[f], order - 1, true),
+                           "用例 " << c << "：" << ppg::filter_family_name(families[f])
+                           << " 在 " << order - 1 << " 阶已满足指标，结果不是最小代价");
+            }
+        }
+
+        std::cout << "  用例 " << c << ": " << ppg::filter_family_name(solution.spec.family)
+                  << " " << order << " 阶, rolloff " << solution.spec.rolloff
+                  << ", 起伏 " << m.ripple_db << " dB, 衰减 " << m.atten_db << " dB" << std::endl;
+    }
+}
+
+static void test_elliptic_rolloff_sweep() {
+    // 过渡带很窄：Elliptic 需要偏离默认陡度（0）才能在该阶数满足指标
+    const ppg::BandPassRequirements req(0.5, 8.0, 0.3, 10.0, 100.0, 0.5, 40.0);
+    const ppg::BandPassSolution solution = ppg::design_min_cost_bandpass(req);
+    TEST_CHECK(solution.spec.family == ppg::FilterFamily::Elliptic,
+               "窄过渡带应选中 Elliptic，实际为 " << ppg::filter_family_name(solution.spec.family));
+    TEST_CHECK(solution.spec.rolloff != 0.0, "选中的陡度应来自扫描（非默认值 0）");
+    TEST_CHECK(!any_candidate_meets(req, ppg::FilterFamily::Elliptic, solution.spec.order, false),
+               "只用默认陡度时 " << solution.spec.order << " 阶已满足指标，陡度扫描未被覆盖");
+}
+
+static void test_infeasible_throws() {
+    // 阻带紧贴通带且要求 80 dB：8 阶以内无法满足
+    bool threw = false;
+    try {
+        ppg::design_min_cost_bandpass(ppg::BandPassRequirements(1.0, 8.0, 0.9, 8.2, 100.0, 0.1, 80.0));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "无法满足的指标应抛出 std::invalid_argument");
+
+    // 边缘顺序错误
+    threw = false;
+    try {
+        ppg::design_min_cost_bandpass(ppg::BandPassRequirements(1.0, 8.0, 2.0, 10.0, 100.0));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "阻带下沿高于通带下沿时应抛出 std::invalid_argument");
+}
+
+int main() {
+    test_solution_is_minimal();
+    test_elliptic_rolloff_sweep();
+    test_infeasible_throws();
+    return test_summary("test_filter_design_solver");
+}
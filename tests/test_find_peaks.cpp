@@ -0,0 +1,299 @@
+#include "find_peaks.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+// =====================================================================
+// 参考实现：原先的 O(P^2) 贪心距离筛选
+// =====================================================================
+
+/**
+ * @brief 逐对比较的距离筛选（重写前的实现）
+ *
+ * 按高度降序处理，每个保留的峰值删除所有距离小于distance的低优先级峰值。
+ * 原实现用不稳定的 std::sort，等高峰值的先后不确定；这里按 scipy 的规则
+ * 固定为等高时位置靠右者优先，作为被测实现的基准。
+ */
+static std::vector<int> reference_filter_by_distance(
+    const std::vector<int>& peaks,
+    const std::vector<float>& signal,
+    int distance
+) {
+    if (distance <= 0 || peaks.empty()) {
+        return peaks;
+    }
+
+    std::vector<int> order(peaks.size());
+    for (size_t i = 0; i < peaks.size(); i++) {
+        order[i] = static_cast<int>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const float height_a = signal[peaks[a]];
+        const float height_b = signal[peaks[b]];
+        if (height_a != height_b) {
+            return height_a > height_b;
+        }
+        return peaks[a] > peaks[b];
+    });
+
+    std::vector<bool> keep(peaks.size(), true);
+    for (size_t i = 0; i < order.size(); i++) {
+        if (!keep[order[i]]) {
+            continue;
+        }
+        for (size_t j = i + 1; j < order.size(); j++) {
+            if (std::abs(peaks[order[i]] - peaks[order[j]]) < distance) {
+                keep[order[j]] = false;
+            }
+        }
+    }
+
+    std::vector<int> filtered_peaks;
+    for (size_t i = 0; i < peaks.size(); i++) {
+        if (keep[i]) {
+            filtered_peaks.push_back(peaks[i]);
+        }
+    }
+    return filtered_peaks;
+}
+
+/**
+ * @brief 带搜索窗口的逐峰值显著性（scipy _peak_prominences 的逐点搜索）
+ *
+ * 与 calculate_prominence 相同的向两侧行走，另按 wlen 截断搜索范围。
+ */
+static float reference_prominence(
+    const std::vector<float>& signal,
+    int peak,
+    int wlen,
+    int& left_base,
+    int& right_base
+) {
+    int left_limit = 0;
+    int right_limit = static_cast<int>(signal.size()) - 1;
+    if (wlen >= 2) {
+        left_limit = std::max(peak - wlen / 2, left_limit);
+        right_limit = std::min(peak + wlen / 2, right_limit);
+    }
+
+    const float peak_height = signal[peak];
+    float left_min = peak_height;
+    left_base = peak;
+    for (int i = peak; i >= left_limit && signal[i] <= peak_height; i--) {
+        if (signal[i] < left_min) {
+            left_min = signal[i];
+            left_base = i;
+        }
+    }
+    float right_min = peak_height;
+    right_base = peak;
+    for (int i = peak; i <= right_limit && signal[i] <= peak_height; i++) {
+        if (signal[i] < right_min) {
+            right_min = signal[i];
+            right_base = i;
+        }
+    }
+    return peak_height - std::max(left_min, right_min);
+}
+
+// =====================================================================
+// filter_peaks_by_distance
+// =====================================================================
+
+static void test_distance_matches_reference() {
+    std::mt19937 rng(21);
+    std::uniform_int_distribution<int> length(0, 400);
+    std::uniform_int_distribution<int> levels(2, 12);
+    std::uniform_int_distribution<int> distance_dist(-1, 40);
+
+    for (int trial = 0; trial < 5000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        // 一半用量化信号（大量等高峰值），一半用连续信号
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+        const int distance = distance_dist(rng);
+
+        const std::vector<int> peaks = find_local_maxima(signal);
+        const std::vector<int> expected = reference_filter_by_distance(peaks, signal, distance);
+        const std::vector<int> actual = filter_peaks_by_distance(peaks, signal, distance);
+        TEST_CHECK(actual == expected,
+                   "filter_peaks_by_distance 与参考实现不一致 (trial " << trial
+                   << ", n=" << n << ", distance=" << distance << ")");
+    }
+}
+
+static void test_distance_tie_break() {
+    // 三个等高峰值都在彼此 distance 以内：靠右者优先，只保留 7
+    const std::vector<float> signal = {0, 5, 0, 0, 5, 0, 0, 5, 0};
+    const std::vector<int> peaks = find_local_maxima(signal);
+    const std::vector<int> kept = filter_peaks_by_distance(peaks, signal, 7);
+    const std::vector<int> expected = {7};
+    TEST_CHECK(kept == expected, "等高峰值应由位置靠右者优先保留");
+
+    // 两个等高峰值相距小于distance：只保留右侧的
+    const std::vector<float> pair = {0, 3, 0, 3, 0};
+    const std::vector<int> kept_pair = filter_peaks_by_distance(find_local_maxima(pair), pair, 3);
+    TEST_CHECK(kept_pair.size() == 1 && kept_pair[0] == 3, "等高峰值对应保留右侧的峰值");
+}
+
+// =====================================================================
+// calculate_prominences
+// =====================================================================
+
+static void test_prominences_match_per_peak_walk() {
+    std::mt19937 rng(22);
+    std::uniform_int_distribution<int> length(0, 400);
+    std::uniform_int_distribution<int> levels(2, 8);
+
+    for (int trial = 0; trial < 3000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+        const std::vector<int> peaks = find_local_maxima(signal);
+
+        std::vector<float> prominences;
+        std::vector<int> left_bases;
+        std::vector<int> right_bases;
+        calculate_prominences(signal, peaks, prominences, left_bases, right_bases);
+        TEST_CHECK(prominences.size() == peaks.size() &&
+                   left_bases.size() == peaks.size() &&
+                   right_bases.size() == peaks.size(),
+                   "calculate_prominences 输出长度与峰值数不一致 (trial " << trial << ")");
+        if (prominences.size() != peaks.size()) {
+            continue;
+        }
+
+        for (size_t i = 0; i < peaks.size(); i++) {
+            int left_base = 0;
+            int right_base = 0;
+            const float expected = calculate_prominence(signal, peaks[i], left_base, right_base);
+            TEST_CHECK(prominences[i] == expected &&
+                       left_bases[i] == left_base && right_bases[i] == right_base,
+                       "显著性与逐峰值搜索不一致 (trial " << trial << ", peak " << peaks[i] << ")");
+        }
+    }
+}
+
+static void test_prominences_with_window() {
+    std::mt19937 rng(122);
+    std::uniform_int_distribution<int> length(1, 400);
+    std::uniform_int_distribution<int> levels(2, 8);
+    std::uniform_int_distribution<int> wlen_dist(-1, 60);
+
+    for (int trial = 0; trial < 3000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+        const int wlen = wlen_dist(rng);
+
+        // 峰值取局部最大值，或任意位置子集（calculate_prominences 不要求是局部最大值）
+        std::vector<int> peaks;
+        if (trial % 3 == 0) {
+            for (size_t i = 0; i < n; i++) {
+                if (rng() % 4 == 0) {
+                    peaks.push_back(static_cast<int>(i));
+                }
+            }
+        } else {
+            peaks = find_local_maxima(signal);
+        }
+
+        std::vector<float> prominences;
+        std::vector<int> left_bases;
+        std::vector<int> right_bases;
+        calculate_prominences(signal, peaks, prominences, left_bases, right_bases, wlen);
+        if (prominences.size() != peaks.size()) {
+            TEST_CHECK(false, "calculate_prominences 输出长度与峰值数不一致 (trial " << trial << ")");
+            continue;
+        }
+
+        for (size_t i = 0; i < peaks.size(); i++) {
+            int left_base = 0;
+            int right_base = 0;
+            const float expected = reference_prominence(signal, peaks[i], wlen, left_base, right_base);
+            TEST_CHECK(prominences[i] == expected &&
+                       left_bases[i] == left_base && right_bases[i] == right_base,
+                       "带窗口的显著性与逐峰值搜索不一致 (trial " << trial
+                       << ", wlen=" << wlen << ", peak " << peaks[i] << ")");
+        }
+    }
+}
+
+static void test_prominence_ties() {
+    // 等高样本不终止搜索：两个峰值都越过对方到达两端的最低点
+    const std::vector<float> signal = {0, 2, 1, 2, 0};
+    const std::vector<int> peaks = {1, 3};
+    std::vector<float> prominences;
+    std::vector<int> left_bases;
+    std::vector<int> right_bases;
+    calculate_prominences(signal, peaks, prominences, left_bases, right_bases);
+    TEST_CHECK(prominences == std::vector<float>({2.0f, 2.0f}), "等高峰值的显著性应为 2");
+    TEST_CHECK(left_bases == std::vector<int>({0, 0}), "等高峰值的左基线应为 0");
+    TEST_CHECK(right_bases == std::vector<int>({4, 4}), "等高峰值的右基线应为 4");
+
+    // 两侧最低点等高时基线取离峰值最近者
+    const std::vector<float> valleys = {1, 0, 3, 0, 1, 0, 3};
+    calculate_prominences(valleys, std::vector<int>({2}), prominences, left_bases, right_bases);
+    TEST_CHECK(prominences.size() == 1 && prominences[0] == 3.0f &&
+               left_bases[0] == 1 && right_bases[0] == 3,
+               "等高最低点应取离峰值最近的位置作为基线");
+}
+
+// =====================================================================
+// find_peaks_and_valleys
+// =====================================================================
+
+static void test_peaks_and_valleys_match_two_passes() {
+    std::mt19937 rng(24);
+    std::uniform_int_distribution<int> length(0, 400);
+    std::uniform_int_distribution<int> levels(2, 6);
+    std::uniform_int_distribution<int> distance_dist(-2, 40);
+
+    std::vector<int> peaks;
+    std::vector<int> valleys;
+    for (int trial = 0; trial < 5000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        // 取值很少的量化信号含大量平台（峰值平台与谷值平台）
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+        const int distance = distance_dist(rng);
+
+        std::vector<float> inverted(n);
+        for (size_t i = 0; i < n; i++) {
+            inverted[i] = -signal[i];
+        }
+        const std::vector<int> expected_peaks = find_peaks(signal, distance);
+        const std::vector<int> expected_valleys = find_peaks(inverted, distance);
+
+        // 输出数组沿用上一轮的内容，验证函数会先清空
+        find_peaks_and_valleys(signal, distance, peaks, valleys);
+        TEST_CHECK(peaks == expected_peaks && valleys == expected_valleys,
+                   "find_peaks_and_valleys 与 find_peaks(x)/find_peaks(-x) 不一致 (trial "
+                   << trial << ", n=" << n << ", distance=" << distance << ")");
+    }
+}
+
+static void test_peaks_and_valleys_plateaus() {
+    // 峰值平台与谷值平台都记在平台的第一个样本
+    const std::vector<float> signal = {0, 2, 2, 2, 1, 1, 3, 0, 0, 0, 1};
+    std::vector<int> peaks;
+    std::vector<int> valleys;
+    find_peaks_and_valleys(signal, 0, peaks, valleys);
+    TEST_CHECK(peaks == std::vector<int>({1, 6}), "峰值平台应取第一个样本");
+    TEST_CHECK(valleys == std::vector<int>({4, 7}), "谷值平台应取第一个样本");
+}
+
+int main() {
+    test_distance_matches_reference();
+    test_distance_tie_break();
+    test_prominences_match_per_peak_walk();
+    test_prominences_with_window();
+    test_prominence_ties();
+    test_peaks_and_valleys_match_two_passes();
+    test_peaks_and_valleys_plateaus();
+    return test_summary("test_find_peaks");
+}
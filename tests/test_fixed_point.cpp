@@ -0,0 +1,111 @@
+#include "realtime_filter.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+// =====================================================================
+// 定点级联：满量程输入下的饱和，以及Q15路径与浮点路径的偏差
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+const int kGainStages = 9;
+
+typedef Dsp::FixedPointCascade<kGainStages + 1> FixedCascade;
+
+/**
+ * @brief 极点在原点的纯FIR节：零点 ±theta（theta=0 时两零点在原点，即纯增益），乘以 gain
+ */
+Dsp::Biquad fir_section(double theta, double gain) {
+    Dsp::Biquad s;
+    const Dsp::complex_t zero = (theta == 0.0) ? Dsp::complex_t(0.0) : std::polar(1.0, theta);
+    s.setTwoPole(0.0, zero, 0.0, std::conj(zero));
+    s.applyScale(gain);
+    return s;
+}
+
+/**
+ * @brief 满量程方波：幅度32767，每 period 个样本翻转一次
+ */
+std::vector<int16_t> full_scale_square(size_t n, size_t period) {
+    std::vector<int16_t> signal(n);
+    for (size_t i = 0; i < n; i++) {
+        signal[i] = ((i / period) % 2 == 0) ? 32767 : -32767;
+    }
+    return signal;
+}
+
+int16_t saturate_q15(double v) {
+    return static_cast<int16_t>(std::min(32767.0, std::max(-32768.0, std::floor(v + 0.5))));
+}
+
+} // namespace
+
+static void test_accumulator_saturates() {
+    // 9节增益≈2的节把满量程输入推到int32饱和，最后一节 b=(1.99,-1.99,1.99)：
+    // 交替符号的饱和状态使5项乘积之和约为 3*2^62，超出int64
+    Dsp::CascadeChain<kGainStages + 1> chain;
+    for (int i = 0; i < kGainStages; i++) {
+        chain.append(fir_section(0.0, 1.99));
+    }
+    // 零点 e^(±j pi/3)：b = (1, -1, 1) * 1.99
+    chain.append(fir_section(M_PI / 3.0, 1.99));
+    const FixedCascade fixed(chain);
+
+    FixedCascade::State state;
+    const std::vector<int16_t> input = full_scale_square(64, 1);
+    std::vector<int16_t> output = input;
+    fixed.process(static_cast<int>(output.size()), output.data(), state);
+
+    // 样本同号时三项同号相加，输出应饱和到输入的符号，而不是回绕成反号
+    int wrong = 0;
+    for (size_t i = 2; i < input.size(); i++) {
+        const int16_t expected = input[i] > 0 ? 32767 : -32768;
+        if (output[i] != expected) {
+            wrong++;
+        }
+    }
+    TEST_CHECK(wrong == 0, "累加超出int64时输出应饱和，有 " << wrong << " 个样本未饱和到正确符号");
+}
+
+static void test_q15_matches_float_at_full_scale() {
+    // 满量程 2 Hz 方波：带通的振铃使浮点输出超出16位范围，Q15路径须饱和
+    ppg::RealtimeFilter float_filter(0.5, 20.0, kSampleRate, 3);
+    ppg::RealtimeFilter q15_filter(0.5, 20.0, kSampleRate, 3);
+    const std::vector<int16_t> input = full_scale_square(20000, 250);
+
+    std::vector<float> float_output(input.begin(), input.end());
+    float_filter.process_block(float_output.data(), float_output.size());
+    std::vector<int16_t> q15_output(input.size());
+    q15_filter.process_block(input.data(), q15_output.data(), input.size());
+
+    // 前5秒含零状态起步的瞬态，之后为周期稳态
+    const size_t settled = static_cast<size_t>(5.0 * kSampleRate);
+    int saturated = 0;
+    int max_drift = 0;
+    int settled_drift = 0;
+    for (size_t i = 0; i < input.size(); i++) {
+        if (float_output[i] > 32767.0f || float_output[i] < -32768.0f) {
+            saturated++;
+        }
+        const int drift = std::abs(static_cast<int>(q15_output[i]) - saturate_q15(float_output[i]));
+        max_drift = std::max(max_drift, drift);
+        if (i >= settled) {
+            settled_drift = std::max(settled_drift, drift);
+        }
+    }
+    TEST_CHECK(saturated > 0, "用例应使浮点输出超出16位范围");
+    // 偏差来自Q31系数量化（0.5 Hz 的极点紧靠 z=1，对系数误差敏感）与输出舍入，
+    // 不随时间累积：实测起步瞬态 4 LSB，稳态 1 LSB
+    TEST_CHECK(max_drift <= 4, "Q15输出与浮点输出最大相差 " << max_drift << " LSB");
+    TEST_CHECK(settled_drift <= 2, "稳态下Q15输出与浮点输出最大相差 " << settled_drift << " LSB");
+    std::cout << "  超出16位范围的样本 " << saturated << ", Q15与浮点最大相差 " << max_drift
+              << " LSB（稳态 " << settled_drift << " LSB）" << std::endl;
+}
+
+int main() {
+    test_accumulator_saturates();
+    test_q15_matches_float_at_full_scale();
+    return test_summary("test_fixed_point");
+}
@@ -0,0 +1,88 @@
+#include "ppg_filters.hpp"
+#include "test_utils.hpp"
+#include <cmath>
+
+// =====================================================================
+// 单精度滤波路径：直接II型不可用，转置直接II型与直接I型可用
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+
+/**
+ * @brief 合成 1000 Hz PPG（ADC量级的直流加脉搏波、呼吸基线与噪声）
+ */
+std::vector<float> synthetic_ppg(std::mt19937& rng, double seconds) {
+    std::normal_distribution<double> noise(0.0, 8.0);
+    const size_t n = static_cast<size_t>(kSampleRate * seconds);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        phase = std::fmod(phase + 1.2 / kSampleRate, 1.0);
+        const double systolic = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        const double dicrotic = std::exp(-std::pow((phase - 0.55) / 0.1, 2.0));
+        const double baseline = 60.0 * std::sin(2.0 * M_PI * 0.25 * t);
+        signal[i] = static_cast<float>(20000.0 + baseline + 300.0 * systolic +
+                                       90.0 * dicrotic + noise(rng));
+    }
+    return signal;
+}
+
+const ppg::PrecisionReport* find_form(const std::vector<ppg::PrecisionReport>& reports,
+                                      const char* form) {
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (reports[i].form == form) {
+            return &reports[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+static void test_float_forms() {
+    std::mt19937 rng(3);
+    const std::vector<float> input = synthetic_ppg(rng, 60.0);
+    const std::vector<ppg::PrecisionReport> reports = ppg::compare_float_precision(
+        input, ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3));
+
+    const ppg::PrecisionReport* tdf2 = find_form(reports, "TransposedDirectFormII<float>");
+    const ppg::PrecisionReport* df2 = find_form(reports, "DirectFormII<float>");
+    const ppg::PrecisionReport* df1 = find_form(reports, "DirectFormI<float>");
+    TEST_CHECK(tdf2 && df2 && df1, "精度报告应包含三种单精度状态结构");
+    if (!tdf2 || !df2 || !df1) {
+        return;
+    }
+
+    // 系数量化对通带的影响可以忽略
+    TEST_CHECK(tdf2->passband_error_db < 0.05,
+               "float系数的通带偏差 " << tdf2->passband_error_db << " dB 过大");
+    // 转置直接II型与直接I型的float状态可用
+    TEST_CHECK(tdf2->snr_db >= 40.0,
+               "TransposedDirectFormII<float> SNR " << tdf2->snr_db << " dB 低于 40 dB");
+    TEST_CHECK(df1->snr_db >= 40.0,
+               "DirectFormI<float> SNR " << df1->snr_db << " dB 低于 40 dB");
+    // 直接II型的状态含被低频极点放大的直流，float舍入淹没脉搏分量
+    TEST_CHECK(df2->snr_db < tdf2->snr_db - 20.0,
+               "DirectFormII<float> SNR " << df2->snr_db << " dB，应比转置结构低 20 dB 以上");
+}
+
+static void test_stage_count_checked() {
+    std::vector<float> input(100, 0.0f);
+    bool threw = false;
+    try {
+        // 6阶带通需要6节，超过精度对比的5节上限
+        ppg::compare_float_precision(input, ppg::BandPassSpec(0.5, 20.0, kSampleRate, 6));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "节数超出范围时应抛出 std::invalid_argument");
+}
+
+int main() {
+    test_float_forms();
+    test_stage_count_checked();
+    return test_summary("test_float_precision");
+}
@@ -0,0 +1,70 @@
+#include "ppg_filters.hpp"
+#include "test_utils.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// =====================================================================
+// 滤波内核吞吐量对比：各内核输出一致，节数超限时抛出
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+const double kAdcOffset = 20000.0;
+
+/**
+ * @brief ADC量级的合成PPG：直流偏置上的脉搏波与噪声
+ */
+std::vector<float> synthetic_ppg(std::mt19937& rng, size_t n) {
+    std::normal_distribution<double> noise(0.0, 8.0);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        phase = std::fmod(phase + 1.2 / kSampleRate, 1.0);
+        const double pulse = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        signal[i] = static_cast<float>(kAdcOffset + 300.0 * pulse + noise(rng));
+    }
+    return signal;
+}
+
+} // namespace
+
+static void test_kernels_agree() {
+    std::mt19937 rng(13);
+    const std::vector<float> input = synthetic_ppg(rng, 20000);
+    const std::vector<ppg::ThroughputReport> reports =
+        ppg::benchmark_filter_kernels(input, 0.5, 20.0, kSampleRate, 3, 1);
+
+    TEST_CHECK(reports.size() == 8, "应报告8种内核，实际 " << reports.size());
+    if (reports.empty()) {
+        return;
+    }
+    TEST_CHECK(reports[0].speedup == 1.0 && reports[0].max_abs_error == 0.0, "第一项应为基线");
+
+    // 零初值下输出含直流量级的启动瞬态：各内核的差异不超过直流偏置处的几个float ulp
+    const double tolerance = 8.0 * kAdcOffset * std::numeric_limits<float>::epsilon();
+    for (size_t i = 0; i < reports.size(); i++) {
+        TEST_CHECK(reports[i].ns_per_sample > 0.0, reports[i].method << "：耗时应为正");
+        TEST_CHECK(reports[i].max_abs_error <= tolerance,
+                   reports[i].method << "：相对基线最大误差 " << reports[i].max_abs_error);
+    }
+}
+
+static void test_stage_count_checked() {
+    std::vector<float> input(100, 0.0f);
+    bool threw = false;
+    try {
+        // 6阶带通需要6节，超过吞吐量对比的5节上限
+        ppg::benchmark_filter_kernels(input, 0.5, 20.0, kSampleRate, 6, 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "节数超出范围时应抛出 std::invalid_argument");
+}
+
+int main() {
+    test_kernels_agree();
+    test_stage_count_checked();
+    return test_summary("test_kernel_benchmark");
+}
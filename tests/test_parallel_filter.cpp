@@ -0,0 +1,108 @@
+#include "parallel_filter.hpp"
+#include "filter_design_cache.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// =====================================================================
+// 分块并行滤波与顺序 processBlock 数值等价
+// =====================================================================
+
+namespace {
+
+typedef Dsp::Butterworth::BandPass<5> Design;
+typedef Design::State<Dsp::TransposedDirectFormII> SequentialState;
+
+const double kSampleRate = 1000.0;
+const double kAdcOffset = 30000.0;
+
+// 允许的最大绝对误差：块内零初值输出含直流量级的阶跃瞬态，先以float存储
+// 再叠加双精度零输入修正，误差为直流量级的float舍入（实测约半个ulp），
+// 上限取直流偏置处的4个ulp
+const double kTolerance = 4.0 * kAdcOffset * std::numeric_limits<float>::epsilon();
+
+/**
+ * @brief 原始ADC量级的合成PPG：大直流偏置上的脉搏波、呼吸基线与噪声
+ */
+std::vector<float> raw_ppg(std::mt19937& rng, size_t n) {
+    std::normal_distribution<double> noise(0.0, 10.0);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        phase = std::fmod(phase + 1.2 / kSampleRate, 1.0);
+        const double pulse = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        signal[i] = static_cast<float>(kAdcOffset + 500.0 * pulse +
+                                       200.0 * std::sin(2.0 * M_PI * 0.25 * t) + noise(rng));
+    }
+    return signal;
+}
+
+} // namespace
+
+static void test_matches_sequential() {
+    Design design;
+    ppg::BandPassDesignPtr cached = ppg::FilterDesignCache::instance().get_bandpass(
+        ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3));
+    design.setStages(cached->stages.data(), cached->num_stages());
+    const int dim = 2 * design.getNumStages();
+
+    std::mt19937 rng(9);
+    // 8块时每块不少于 kParallelMinChunk 个样本，长度不是块数的整数倍
+    const size_t n = 8 * ppg::kParallelMinChunk + 12345;
+    const std::vector<float> input = raw_ppg(rng, n);
+    const int chunk_counts[] = { 2, 4, 8 };
+
+    for (int direction = 0; direction < 2; direction++) {
+        const bool reverse = (direction == 1);
+        for (int steady = 0; steady < 2; steady++) {
+            // 顺序参考：零初值或以首个处理样本的稳态开始（filtfilt 的用法）
+            SequentialState sequential;
+            if (steady) {
+                sequential.setSteadyState(reverse ? input[n - 1] : input[0], design);
+            }
+            double initial_state[2 * ppg::kParallelMaxStages];
+            sequential.getState(initial_state, design);
+
+            std::vector<float> expected = input;
+            sequential.processBlock(static_cast<int>(n), reverse ? &expected[n - 1] : &expected[0],
+                                    design, reverse ? -1 : 1);
+            double expected_state[2 * ppg::kParallelMaxStages];
+            sequential.getState(expected_state, design);
+
+            for (int c = 0; c < 3; c++) {
+                std::vector<float> actual = input;
+                double state[2 * ppg::kParallelMaxStages];
+                std::copy(initial_state, initial_state + dim, state);
+                ppg::parallel_cascade_filter(design, actual.data(), n, state, reverse,
+                                             chunk_counts[c]);
+
+                double max_diff = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    max_diff = std::max(max_diff, std::fabs(static_cast<double>(actual[i]) - expected[i]));
+                }
+                double max_state_diff = 0.0;
+                for (int i = 0; i < dim; i++) {
+                    max_state_diff = std::max(max_state_diff, std::fabs(state[i] - expected_state[i]));
+                }
+
+                TEST_CHECK(max_diff <= kTolerance,
+                           (reverse ? "反向" : "正向") << (steady ? "稳态初值" : "零初值")
+                           << " " << chunk_counts[c] << " 块：输出与顺序滤波最大相差 " << max_diff);
+                TEST_CHECK(max_state_diff <= kTolerance,
+                           (reverse ? "反向" : "正向") << (steady ? "稳态初值" : "零初值")
+                           << " " << chunk_counts[c] << " 块：结束状态与顺序滤波最大相差 "
+                           << max_state_diff);
+                std::cout << "  " << (reverse ? "反向" : "正向") << (steady ? "稳态初值" : "零初值")
+                          << " " << chunk_counts[c] << " 块: 最大误差 " << max_diff
+                          << ", 状态误差 " << max_state_diff << std::endl;
+            }
+        }
+    }
+}
+
+int main() {
+    test_matches_sequential();
+    return test_summary("test_parallel_filter");
+}
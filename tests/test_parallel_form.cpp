@@ -0,0 +1,150 @@
+#include "filter_design_cache.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+// =====================================================================
+// 并联实现（部分分式展开）与级联输出一致
+// =====================================================================
+
+namespace {
+
+typedef Dsp::CascadeChain<8> Chain;
+typedef Dsp::ParallelForm<8> Parallel;
+
+// 参考级联不注入防非正规数的交流量：注入点在第一节之后，设计把增益集中在
+// 第一节时（窄带、低频带通），后续各节会把 1e-8 的注入量放大到输出量级
+typedef Chain::State<Dsp::TransposedDirectFormII, Dsp::DenormalIgnore> ReferenceState;
+
+// 两种结构都是双精度，相对峰值的差异实测在 1e-10 左右
+const double kTolerance = 1e-8;
+
+/**
+ * @brief 时域（随机输入）与频域（Cascade::response 与 ParallelForm::response）
+ *        相对峰值的最大差异
+ */
+void compare(const Chain& cascade, const char* name) {
+    const Parallel parallel(cascade);
+
+    ReferenceState cascade_state;
+    Parallel::State parallel_state;
+    std::mt19937 rng(14);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> expected(20000);
+    std::vector<double> actual(expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        const double x = noise(rng);
+        expected[i] = cascade_state.process(x, cascade);
+        actual[i] = x;
+    }
+    // 块接口：FIR直接项只有一个抽头时走按节数展开的内核，否则逐样本
+    parallel.process(static_cast<int>(actual.size()), actual.data(), parallel_state);
+
+    double max_diff = 0.0;
+    double peak = 0.0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        max_diff = std::max(max_diff, std::fabs(actual[i] - expected[i]));
+        peak = std::max(peak, std::fabs(expected[i]));
+    }
+
+    double max_response_diff = 0.0;
+    double peak_response = 0.0;
+    for (int i = 0; i <= 2000; i++) {
+        const double f = 0.5 * i / 2000;
+        max_response_diff = std::max(max_response_diff,
+                                     std::abs(parallel.response(f) - cascade.response(f)));
+        peak_response = std::max(peak_response, std::abs(cascade.response(f)));
+    }
+
+    const double time_error = max_diff / peak;
+    const double response_error = max_response_diff / peak_response;
+    TEST_CHECK(time_error <= kTolerance, name << "：输出相对误差 " << time_error);
+    TEST_CHECK(response_error <= kTolerance, name << "：频率响应相对误差 " << response_error);
+    std::cout << "  " << name << ": " << parallel.getNumSections() << " 节, FIR "
+              << parallel.getNumFirTaps() << " 抽头, 输出 " << time_error
+              << ", 响应 " << response_error << std::endl;
+}
+
+Chain chain_of(const ppg::BandPassSpec& spec) {
+    ppg::BandPassDesignPtr design = ppg::design_bandpass(spec);
+    Chain chain;
+    for (int i = 0; i < design->num_stages(); i++) {
+        chain.append(design->stages[i]);
+    }
+    return chain;
+}
+
+/**
+ * @brief 一节共轭极点对 radius*e^(±j theta)，零点在 ±1（带通型）
+ */
+Dsp::Biquad resonator(double radius, double theta) {
+    const Dsp::complex_t pole = std::polar(radius, theta);
+    Dsp::Biquad stage;
+    stage.setTwoPole(pole, 1.0, std::conj(pole), -1.0);
+    return stage;
+}
+
+} // namespace
+
+static void test_designs_match_cascade() {
+    const ppg::FilterFamily families[] = {
+        ppg::FilterFamily::Butterworth, ppg::FilterFamily::ChebyshevI, ppg::FilterFamily::Elliptic
+    };
+    for (size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++) {
+        const std::string family = ppg::filter_family_name(families[f]);
+        compare(chain_of(ppg::BandPassSpec(0.5, 20.0, 1000.0, 3, families[f])),
+                (family + " 0.5-20Hz@1kHz").c_str());
+        compare(chain_of(ppg::BandPassSpec(0.5, 8.0, 100.0, 4, families[f])),
+                (family + " 0.5-8Hz@100Hz").c_str());
+        // 窄带低频：8个极点挤在 z=1 附近，留数大且相互抵消
+        compare(chain_of(ppg::BandPassSpec(0.5, 0.7, 1000.0, 4, families[f])),
+                (family + " 0.5-0.7Hz@1kHz").c_str());
+    }
+}
+
+static void test_fir_direct_term() {
+    // 带通后接中心差分：分子比分母高两阶，FIR直接项有3个抽头
+    Chain chain = chain_of(ppg::BandPassSpec(0.5, 20.0, 1000.0, 3));
+    chain.appendDifferentiator(1000.0);
+    TEST_CHECK(Parallel(chain).getNumFirTaps() == 3, "分子高两阶时FIR直接项应有3个抽头");
+    compare(chain, "带通+微分");
+
+    // 纯FIR（无极点）：全部由直接项承担
+    Chain fir;
+    fir.appendDifferentiator(1000.0);
+    TEST_CHECK(Parallel(fir).getNumSections() == 0, "无极点时不应有二阶节");
+    compare(fir, "纯微分");
+}
+
+static void test_near_repeated_poles() {
+    const double deltas[] = { 1e-2, 1e-3, 1e-4 };
+    for (size_t i = 0; i < sizeof(deltas) / sizeof(deltas[0]); i++) {
+        Chain chain;
+        chain.append(resonator(0.95, 0.3));
+        chain.append(resonator(0.95 * (1.0 - deltas[i]), 0.3));
+        std::ostringstream name;
+        name << "极点半径相差 " << deltas[i];
+        compare(chain, name.str().c_str());
+    }
+
+    // 完全重复的极点无法展开：抛出而不是得到无穷大的留数
+    Chain repeated;
+    repeated.append(resonator(0.95, 0.3));
+    repeated.append(resonator(0.95, 0.3));
+    bool threw = false;
+    try {
+        Parallel parallel(repeated);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "重复极点应抛出 std::logic_error");
+}
+
+int main() {
+    test_designs_match_cascade();
+    test_fir_direct_term();
+    test_near_repeated_poles();
+    return test_summary("test_parallel_form");
+}
@@ -0,0 +1,154 @@
+#include "ppg_analysis.hpp"
+#include "find_peaks.hpp"
+#include "test_utils.hpp"
+
+// =====================================================================
+// 参考实现：原先的逐峰值扫描全部谷值的配对 O(P·V)
+// =====================================================================
+
+/**
+ * @brief 按旧的双重循环生成逐搏记录与平均AC分量
+ *
+ * 每个峰值扫描全部谷值，取之前最近与之后最近者；求和顺序与旧实现相同，
+ * 平均值因此可以逐位比较。
+ */
+static bool reference_pair_beats(
+    const std::vector<float>& signal,
+    const std::vector<int>& peaks,
+    const std::vector<int>& valleys,
+    ppg::BeatRecords& beats,
+    float& ac_component
+) {
+    beats.clear();
+    ac_component = 0.0f;
+    if (peaks.empty() || valleys.empty()) {
+        return false;
+    }
+
+    float sum_ac = 0.0f;
+    int count = 0;
+    for (int peak : peaks) {
+        int valley_before = -1;
+        int valley_after = -1;
+        for (int valley : valleys) {
+            if (valley < peak) {
+                if (valley_before == -1 || valley > valley_before) {
+                    valley_before = valley;
+                }
+            } else if (valley > peak) {
+                if (valley_after == -1 || valley < valley_after) {
+                    valley_after = valley;
+                }
+            }
+        }
+
+        float amplitude = 0.0f;
+        if (valley_before >= 0 && valley_after >= 0) {
+            const float valley_avg = (signal[valley_before] + signal[valley_after]) / 2.0f;
+            amplitude = signal[peak] - valley_avg;
+        } else if (valley_before >= 0) {
+            amplitude = signal[peak] - signal[valley_before];
+        } else if (valley_after >= 0) {
+            amplitude = signal[peak] - signal[valley_after];
+        } else {
+            continue;
+        }
+
+        sum_ac += amplitude;
+        count++;
+        beats.peaks.push_back(peak);
+        beats.valleys_before.push_back(valley_before);
+        beats.valleys_after.push_back(valley_after);
+        beats.amplitudes.push_back(amplitude);
+        beats.rise_samples.push_back(valley_before >= 0 ? peak - valley_before : -1);
+    }
+
+    if (count > 0) {
+        ac_component = sum_ac / count;
+        return true;
+    }
+    return false;
+}
+
+// =====================================================================
+// pair_beats / calculate_ac_component
+// =====================================================================
+
+static void test_pair_beats_matches_reference() {
+    std::mt19937 rng(25);
+    std::uniform_int_distribution<int> length(0, 400);
+    std::uniform_int_distribution<int> levels(2, 50);
+    std::uniform_int_distribution<int> distance_dist(0, 30);
+    std::uniform_int_distribution<int> coin(0, 3);
+
+    ppg::BeatRecords beats;
+    ppg::BeatRecords expected;
+    for (int trial = 0; trial < 5000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+
+        std::vector<int> peaks;
+        std::vector<int> valleys;
+        find_peaks_and_valleys(signal, distance_dist(rng), peaks, valleys);
+        // 截掉一侧的部分谷值或峰值，覆盖只有一侧谷值与没有谷值的峰值
+        if (coin(rng) == 0 && !valleys.empty()) {
+            valleys.resize(rng() % valleys.size());
+        }
+        if (coin(rng) == 0 && !peaks.empty()) {
+            peaks.erase(peaks.begin(), peaks.begin() + rng() % peaks.size());
+        }
+
+        float expected_ac = 0.0f;
+        const bool expected_paired = reference_pair_beats(signal, peaks, valleys, expected, expected_ac);
+
+        // 记录沿用上一轮的内容，验证 pair_beats 会先清空
+        ppg::pair_beats(signal, peaks, valleys, beats);
+        TEST_CHECK(beats.peaks == expected.peaks &&
+                   beats.valleys_before == expected.valleys_before &&
+                   beats.valleys_after == expected.valleys_after &&
+                   beats.amplitudes == expected.amplitudes &&
+                   beats.rise_samples == expected.rise_samples,
+                   "pair_beats 的逐搏记录与参考实现不一致 (trial " << trial << ")");
+        TEST_CHECK(beats.mean_amplitude() == expected_ac,
+                   "mean_amplitude 与参考实现不一致 (trial " << trial << "): "
+                   << beats.mean_amplitude() << " vs " << expected_ac);
+
+        float ac_component = -1.0f;
+        const bool paired = ppg::calculate_ac_component(signal, peaks, valleys, ac_component);
+        TEST_CHECK(paired == expected_paired && ac_component == expected_ac,
+                   "calculate_ac_component 与参考实现不一致 (trial " << trial << ")");
+    }
+}
+
+static void test_pair_beats_edges() {
+    //              0  1  2  3  4  5  6  7  8
+    const std::vector<float> signal = {5, 1, 6, 2, 8, 0, 4, 3, 9};
+    ppg::BeatRecords beats;
+
+    // 第一个峰值之前没有谷值，最后一个峰值之后没有谷值
+    ppg::pair_beats(signal, std::vector<int>({0, 4, 8}), std::vector<int>({1, 5}), beats);
+    TEST_CHECK(beats.size() == 3, "三个峰值都应有记录");
+    if (beats.size() == 3) {
+        TEST_CHECK(beats.valleys_before[0] == -1 && beats.valleys_after[0] == 1 &&
+                   beats.amplitudes[0] == 4.0f && beats.rise_samples[0] == -1,
+                   "只有后谷值的峰值取该侧幅度，上升时间为-1");
+        TEST_CHECK(beats.valleys_before[1] == 1 && beats.valleys_after[1] == 5 &&
+                   beats.amplitudes[1] == 7.5f && beats.rise_samples[1] == 3,
+                   "两侧都有谷值时取两侧平均");
+        TEST_CHECK(beats.valleys_before[2] == 5 && beats.valleys_after[2] == -1 &&
+                   beats.amplitudes[2] == 9.0f && beats.rise_samples[2] == 3,
+                   "只有前谷值的峰值取该侧幅度");
+    }
+
+    // 没有谷值：没有记录，平均为0
+    ppg::pair_beats(signal, std::vector<int>({2, 4}), std::vector<int>(), beats);
+    TEST_CHECK(beats.size() == 0 && beats.mean_amplitude() == 0.0f, "没有谷值时不应产生记录");
+}
+
+int main() {
+    test_pair_beats_matches_reference();
+    test_pair_beats_edges();
+    return test_summary("test_ppg_analysis");
+}
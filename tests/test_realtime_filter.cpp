@@ -0,0 +1,265 @@
+#include "realtime_filter.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+// =====================================================================
+// RealtimeFilter：重调谐与稳态初始化
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+
+/**
+ * @brief 直流偏置上叠加单频正弦
+ */
+std::vector<float> tone(double frequency, double offset, double amplitude, size_t n) {
+    std::vector<float> signal(n);
+    for (size_t i = 0; i < n; i++) {
+        signal[i] = static_cast<float>(offset + amplitude *
+                                       std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+    }
+    return signal;
+}
+
+double max_abs_difference(const std::vector<float>& a, const std::vector<float>& b) {
+    double max_diff = 0.0;
+    for (size_t i = 0; i < std::min(a.size(), b.size()); i++) {
+        max_diff = std::max(max_diff, std::fabs(static_cast<double>(a[i]) - b[i]));
+    }
+    return max_diff;
+}
+
+typedef Dsp::CascadeChain<6> Chain;
+
+Chain design_chain(const ppg::BandPassSpec& spec) {
+    ppg::BandPassDesignPtr design = ppg::FilterDesignCache::instance().get_bandpass(spec);
+    Chain chain;
+    for (int i = 0; i < design->num_stages(); i++) {
+        chain.append(design->stages[i]);
+    }
+    return chain;
+}
+
+/**
+ * @brief 级联各节极点模的最大值（小于1即稳定）
+ */
+double max_pole_radius(const Dsp::Cascade& cascade) {
+    double radius = 0.0;
+    for (int i = 0; i < cascade.getNumStages(); i++) {
+        const double a1 = cascade[i].getA1() / cascade[i].getA0();
+        const double a2 = cascade[i].getA2() / cascade[i].getA0();
+        const std::complex<double> d = std::sqrt(std::complex<double>(a1 * a1 - 4.0 * a2));
+        radius = std::max(radius, std::max(std::abs(0.5 * (-a1 + d)), std::abs(0.5 * (-a1 - d))));
+    }
+    return radius;
+}
+
+bool same_coefficients(const Dsp::Cascade& a, const Dsp::Cascade& b) {
+    if (a.getNumStages() != b.getNumStages()) {
+        return false;
+    }
+    for (int i = 0; i < a.getNumStages(); i++) {
+        if (a[i].getA0() != b[i].getA0() || a[i].getA1() != b[i].getA1() ||
+            a[i].getA2() != b[i].getA2() || a[i].getB0() != b[i].getB0() ||
+            a[i].getB1() != b[i].getB1() || a[i].getB2() != b[i].getB2()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 逐样本推进过渡，检查每个中间级联稳定，返回是否恰好停在终点系数上
+ */
+bool run_transition(Dsp::CascadeTransition<6>& transition, const Chain& target, int steps,
+                    double& max_radius) {
+    for (int n = 0; n < steps; n++) {
+        transition.advance();
+        max_radius = std::max(max_radius, max_pole_radius(transition));
+    }
+    return transition.getRemainingSamples() == 0 && same_coefficients(transition, target);
+}
+
+} // namespace
+
+// =====================================================================
+// 过渡：每个中间级联稳定，结束时恰好为目标系数
+// =====================================================================
+
+static void test_transition_path() {
+    struct Case {
+        double from_low, from_high, to_low, to_high;
+        int order;
+    };
+    const Case cases[] = {
+        { 0.5, 20.0, 0.5, 8.0, 3 },
+        { 0.5, 8.0, 5.0, 40.0, 3 },
+        { 0.5, 20.0, 0.5, 3.0, 6 },     // 6节：RealtimeFilter 的上限
+        { 0.5, 3.0, 10.0, 40.0, 6 }
+    };
+    const int steps = 500;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const Chain from = design_chain(ppg::BandPassSpec(cases[c].from_low, cases[c].from_high,
+                                                          kSampleRate, cases[c].order));
+        const Chain to = design_chain(ppg::BandPassSpec(cases[c].to_low, cases[c].to_high,
+                                                        kSampleRate, cases[c].order));
+        Dsp::CascadeTransition<6> transition;
+        transition.setup(from, to, steps);
+        double max_radius = max_pole_radius(transition);
+        const bool landed = run_transition(transition, to, steps, max_radius);
+        TEST_CHECK(landed, "用例 " << c << "：过渡结束时应恰好为目标系数");
+        TEST_CHECK(max_radius < 1.0, "用例 " << c << "：中间级联的极点模最大为 " << max_radius);
+    }
+
+    // 过渡进行到一半时改变目标：从当前插值位置出发，同样稳定并停在新目标上
+    const Chain first = design_chain(ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3));
+    const Chain second = design_chain(ppg::BandPassSpec(0.5, 8.0, kSampleRate, 3));
+    const Chain third = design_chain(ppg::BandPassSpec(2.0, 40.0, kSampleRate, 3));
+    Dsp::CascadeTransition<6> transition;
+    transition.setup(first, second, steps);
+    double max_radius = 0.0;
+    run_transition(transition, second, steps / 2, max_radius);
+    transition.setup(transition, third, steps);
+    const bool landed = run_transition(transition, third, steps, max_radius);
+    TEST_CHECK(landed, "中途改变目标后，过渡结束时应恰好为新目标系数");
+    TEST_CHECK(max_radius < 1.0, "中途改变目标时中间级联的极点模最大为 " << max_radius);
+}
+
+// =====================================================================
+// 过渡期间的输出有界：原始ADC量级的直流偏置不产生瞬态
+// =====================================================================
+
+static void test_transition_output_bounded() {
+    const double offset = 30000.0;
+    const double amplitude = 500.0;
+    const double seconds_before = 5.0;
+    const double seconds_after = 25.0;     // 含 Q 较高的极点，瞬态衰减较慢
+    const std::vector<float> input = tone(2.0, offset, amplitude,
+                                          static_cast<size_t>((seconds_before + seconds_after) * kSampleRate));
+    const size_t retune_at = static_cast<size_t>(seconds_before * kSampleRate);
+
+    // ChebyshevII 偶数阶带通在直流处有阻带纹波量级的增益（此处1%），
+    // 直流参考的增益须在新旧设计之间插值
+    const ppg::FilterFamily families[] = { ppg::FilterFamily::Butterworth, ppg::FilterFamily::ChebyshevII };
+    const int transitions[] = { 20, 500, 2000 };
+    for (size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++) {
+        const char* family = ppg::filter_family_name(families[f]);
+        // 新通带的参考：从头就是目标设计
+        ppg::BandPassSpec target(0.5, 8.0, kSampleRate, 4, families[f]);
+        ppg::RealtimeFilter fresh(target);
+        fresh.prime(static_cast<float>(offset));
+        std::vector<float> expected(input.size());
+        fresh.process_block(input.data(), expected.data(), input.size());
+
+        for (size_t t = 0; t < sizeof(transitions) / sizeof(transitions[0]); t++) {
+            for (int block = 0; block < 2; block++) {
+                ppg::RealtimeFilter filter(ppg::BandPassSpec(0.5, 20.0, kSampleRate, 4, families[f]));
+                filter.prime(static_cast<float>(offset));
+                std::vector<float> output(input.size());
+                for (size_t i = 0; i < input.size(); ) {
+                    if (i == retune_at) {
+                        filter.retune(0.5, 8.0, transitions[t]);
+                    }
+                    size_t n = 1;
+                    if (block) {
+                        // 传感器FIFO式的64样本块，在重调谐处截断；过渡跨越多个块
+                        const size_t end = (i < retune_at) ? retune_at : input.size();
+                        n = std::min<size_t>(64, end - i);
+                        filter.process_block(&input[i], &output[i], n);
+                    } else {
+                        output[i] = filter.process_sample(input[i]);
+                    }
+                    i += n;
+                }
+
+                // 过渡期间及随后3秒：两个通带都让2Hz通过，输出幅度应保持在信号幅度附近，
+                // 相邻样本之差不超过重调谐前的几倍（过渡的起点和终点没有阶跃）
+                double peak = 0.0;
+                double step = 0.0;
+                double step_before = 0.0;
+                const size_t settle = retune_at + transitions[t] + static_cast<size_t>(3.0 * kSampleRate);
+                for (size_t i = retune_at - 1000; i < settle; i++) {
+                    const double change = std::fabs(static_cast<double>(output[i]) - output[i - 1]);
+                    if (i < retune_at) {
+                        step_before = std::max(step_before, change);
+                    } else {
+                        step = std::max(step, change);
+                        peak = std::max(peak, std::fabs(static_cast<double>(output[i])));
+                    }
+                }
+                TEST_CHECK(peak <= 2.0 * amplitude,
+                           "[" << family << (block ? " 块" : " 逐样本") << "] 过渡 " << transitions[t]
+                           << " 样本期间输出峰值 " << peak << "，超过信号幅度的2倍");
+                TEST_CHECK(step <= 4.0 * step_before,
+                           "[" << family << (block ? " 块" : " 逐样本") << "] 过渡 " << transitions[t]
+                           << " 样本期间相邻样本最大相差 " << step << "，重调谐前为 " << step_before);
+
+                // 瞬态衰减后（最后2秒）与从头使用目标设计的滤波器一致：结束在目标系数与正确状态上
+                const std::vector<float> tail_out(output.end() - static_cast<long>(2.0 * kSampleRate), output.end());
+                const std::vector<float> tail_ref(expected.end() - static_cast<long>(2.0 * kSampleRate), expected.end());
+                const double tail_diff = max_abs_difference(tail_out, tail_ref);
+                TEST_CHECK(tail_diff <= 1e-2,
+                           "[" << family << (block ? " 块" : " 逐样本") << "] 过渡 " << transitions[t]
+                           << " 样本后与目标滤波器相差 " << tail_diff);
+                std::cout << "  " << family << (block ? " 块" : " 逐样本") << " 过渡 " << transitions[t]
+                          << ": 峰值 " << peak << ", 相邻样本差 " << step << "/" << step_before
+                          << ", 稳定后相差 " << tail_diff << std::endl;
+            }
+        }
+    }
+}
+
+// =====================================================================
+// 过渡中 prime：放弃过渡，按目标通带从稳态开始
+// =====================================================================
+
+static void test_prime_during_retune() {
+    const ppg::FilterRealization realizations[] = {
+        ppg::FilterRealization::Cascade, ppg::FilterRealization::Parallel
+    };
+    const char* names[] = { "级联", "并联" };
+    const std::vector<float> input = tone(15.0, 1000.0, 100.0, 4000);
+
+    for (int r = 0; r < 2; r++) {
+        ppg::RealtimeFilter fresh(ppg::BandPassSpec(0.5, 8.0, kSampleRate, 3), realizations[r]);
+        fresh.prime(1000.0f);
+
+        // 块路径与逐样本路径各用一个重调谐后立即 prime 的滤波器
+        ppg::RealtimeFilter block_filter(ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3), realizations[r]);
+        block_filter.retune(0.5, 8.0, 500);
+        block_filter.prime(1000.0f);
+        ppg::RealtimeFilter sample_filter(ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3), realizations[r]);
+        sample_filter.retune(0.5, 8.0, 500);
+        sample_filter.prime(1000.0f);
+        TEST_CHECK(block_filter.transition_remaining() == 0,
+                   "[" << names[r] << "] prime 后不应有进行中的过渡");
+
+        std::vector<float> expected(input.size());
+        std::vector<float> block_output(input.size());
+        std::vector<float> sample_output(input.size());
+        fresh.process_block(input.data(), expected.data(), input.size());
+        block_filter.process_block(input.data(), block_output.data(), input.size());
+        for (size_t i = 0; i < input.size(); i++) {
+            sample_output[i] = sample_filter.process_sample(input[i]);
+        }
+
+        const double block_diff = max_abs_difference(block_output, expected);
+        const double sample_diff = max_abs_difference(sample_output, expected);
+        TEST_CHECK(block_diff <= 1e-3,
+                   "[" << names[r] << "] 重调谐后 prime 的块输出与新建的 0.5-8Hz 滤波器相差 "
+                   << block_diff);
+        TEST_CHECK(sample_diff <= 1e-3,
+                   "[" << names[r] << "] 重调谐后 prime 的逐样本输出与新建的 0.5-8Hz 滤波器相差 "
+                   << sample_diff);
+    }
+}
+
+int main() {
+    test_prime_during_retune();
+    test_transition_path();
+    test_transition_output_bounded();
+    return test_summary("test_realtime_filter");
+}
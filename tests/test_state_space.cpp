@@ -0,0 +1,135 @@
+#include "ppg_filters.hpp"
+#include "filter_design_cache.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// =====================================================================
+// 分块状态空间内核与级联递推数值等价（正反向、非整块长度、filtfilt）
+// =====================================================================
+
+namespace {
+
+typedef Dsp::SimpleFilter<Dsp::Butterworth::BandPass<5>, 1> Filter;
+typedef Filter::State<Dsp::TransposedDirectFormII> RecursiveState;
+
+const double kSampleRate = 1000.0;
+const double kAdcOffset = 30000.0;
+const double kPulseAmplitude = 500.0;
+const int kBlockSize = 16;  // Dsp::BlockStateSpace 的默认块长
+
+// 两种内核的双精度运算顺序不同：输出（带通后不含直流）的差异只是float舍入，
+// 上限取两倍脉搏幅度处的4个ulp；状态为双精度且含直流，上限取直流偏置的1e-9
+const double kOutputTolerance = 4.0 * 2.0 * kPulseAmplitude * std::numeric_limits<float>::epsilon();
+const double kStateTolerance = 1e-9 * kAdcOffset;
+
+/**
+ * @brief 原始ADC量级的合成PPG：大直流偏置上的脉搏波与噪声
+ */
+std::vector<float> raw_ppg(std::mt19937& rng, size_t n) {
+    std::normal_distribution<double> noise(0.0, 10.0);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        phase = std::fmod(phase + 1.2 / kSampleRate, 1.0);
+        const double pulse = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        signal[i] = static_cast<float>(kAdcOffset + kPulseAmplitude * pulse + noise(rng));
+    }
+    return signal;
+}
+
+double max_abs_difference(const std::vector<float>& a, const std::vector<float>& b) {
+    double max_diff = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        max_diff = std::max(max_diff, std::fabs(static_cast<double>(a[i]) - b[i]));
+    }
+    return max_diff;
+}
+
+void load_design(Filter& filter) {
+    ppg::BandPassDesignPtr design = ppg::FilterDesignCache::instance().get_bandpass(
+        ppg::BandPassSpec(0.5, 20.0, kSampleRate, 3));
+    filter.setStages(design->stages.data(), design->num_stages());
+}
+
+} // namespace
+
+static void test_block_kernel_matches_recursive() {
+    Filter filter;
+    load_design(filter);
+    const int dim = 2 * filter.getNumStages();
+    Dsp::BlockStateSpace<Filter::MaxStages> block_kernel(filter);
+
+    std::mt19937 rng(15);
+    // 不足一块、恰好一块、整块加余数
+    const int lengths[] = { 1, kBlockSize - 1, kBlockSize, kBlockSize + 1, 3 * kBlockSize + 5, 4099 };
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        const int n = lengths[l];
+        const std::vector<float> input = raw_ppg(rng, n);
+        for (int direction = 0; direction < 2; direction++) {
+            const bool reverse = (direction == 1);
+            const int start = reverse ? n - 1 : 0;
+            const int stride = reverse ? -1 : 1;
+
+            RecursiveState recursive;
+            recursive.setSteadyState(input[start], filter);
+            double block_state[2 * Filter::MaxStages];
+            recursive.getState(block_state, filter);
+
+            std::vector<float> expected = input;
+            recursive.processBlock(n, &expected[start], filter, stride);
+            double expected_state[2 * Filter::MaxStages];
+            recursive.getState(expected_state, filter);
+
+            std::vector<float> actual = input;
+            block_kernel.process(n, &actual[start], block_state, stride);
+
+            double max_state_diff = 0.0;
+            for (int i = 0; i < dim; i++) {
+                max_state_diff = std::max(max_state_diff, std::fabs(block_state[i] - expected_state[i]));
+            }
+            const double max_diff = max_abs_difference(actual, expected);
+            TEST_CHECK(max_diff <= kOutputTolerance,
+                       (reverse ? "反向" : "正向") << " n=" << n << "：输出与级联递推最大相差 " << max_diff);
+            TEST_CHECK(max_state_diff <= kStateTolerance,
+                       (reverse ? "反向" : "正向") << " n=" << n << "：结束状态与级联递推最大相差 "
+                       << max_state_diff);
+        }
+    }
+}
+
+static void test_filtfilt_kernels_match() {
+    Filter filter;
+    load_design(filter);
+    const int padlen = 3 * (2 * filter.getNumStages() + 1);
+
+    std::mt19937 rng(115);
+    // padlen 附近（信号主体不足一块）以及各种不是块长整数倍的长度
+    const int lengths[] = { padlen + 1, padlen + 2, 2 * kBlockSize - 1, 2 * kBlockSize + 1,
+                            1001, 4096, 5003 };
+    double overall = 0.0;
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        const int n = lengths[l];
+        const std::vector<float> input = raw_ppg(rng, n);
+
+        std::vector<float> cascade = input;
+        ppg::filtfilt(filter, cascade.data(), n, ppg::PadType::Odd, -1, nullptr, 0, 1,
+                      ppg::FilterKernel::Cascade);
+        std::vector<float> state_space = input;
+        ppg::filtfilt(filter, state_space.data(), n, ppg::PadType::Odd, -1, nullptr, 0, 1,
+                      ppg::FilterKernel::StateSpace);
+
+        const double max_diff = max_abs_difference(state_space, cascade);
+        overall = std::max(overall, max_diff);
+        TEST_CHECK(max_diff <= kOutputTolerance,
+                   "filtfilt n=" << n << "：状态空间内核与级联内核最大相差 " << max_diff);
+    }
+    std::cout << "  filtfilt 两种内核最大差异 " << overall << "（上限 " << kOutputTolerance << "）" << std::endl;
+}
+
+int main() {
+    test_block_kernel_matches_recursive();
+    test_filtfilt_kernels_match();
+    return test_summary("test_state_space");
+}
@@ -0,0 +1,99 @@
+#include "streaming_filtfilt.hpp"
+#include "ppg_filters.hpp"
+#include "signal_io.hpp"
+#include "test_utils.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// =====================================================================
+// 分块落盘的零相位滤波与内存版本逐字节一致
+// =====================================================================
+
+namespace {
+
+const char* kInputPath = "test_streaming_filtfilt_input.txt";
+const char* kOutputPath = "test_streaming_filtfilt_output.txt";
+const char* kReferencePath = "test_streaming_filtfilt_reference.txt";
+
+const ppg::BandPassSpec kSpec(0.5, 20.0, 1000.0, 3);
+
+// 输出小数位数：信号幅度在1附近，9位小数足以区分相邻float，文本相同即逐位一致
+const int kPrecision = 9;
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+bool file_exists(const std::string& path) {
+    std::ifstream in(path.c_str());
+    return in.is_open();
+}
+
+/**
+ * @brief 写入长度为 n 的随机输入，分别用文件版本与内存版本滤波并比较输出
+ */
+void check_length(std::mt19937& rng, size_t n, size_t chunk_samples) {
+    ppg::save_signal_to_file(random_smooth_signal(rng, n), kInputPath);
+
+    // 内存版本读入的是同一份文本，两边的输入完全相同
+    const std::vector<float> input = ppg::read_signal_from_file(kInputPath);
+    ppg::save_signal_to_file(ppg::apply_bandpass_zerophase(input, kSpec), kReferencePath, kPrecision);
+
+    const size_t processed = ppg::apply_bandpass_zerophase_file(
+        kInputPath, kOutputPath, kSpec, chunk_samples, kPrecision);
+    TEST_CHECK(processed == n, "处理的样本数 " << processed << " 应为 " << n);
+    TEST_CHECK(read_file(kOutputPath) == read_file(kReferencePath),
+               "分块落盘输出与内存版本不一致 (n=" << n << ", chunk=" << chunk_samples << ")");
+    TEST_CHECK(!file_exists(std::string(kOutputPath) + ".spill"),
+               "成功返回后溢出文件仍然存在 (n=" << n << ")");
+}
+
+} // namespace
+
+static void test_matches_in_memory() {
+    std::mt19937 rng(20);
+    // 分块大小取 BlockTileSize（512）时：块长附近、两块附近、多块
+    const size_t tile = Dsp::Cascade::BlockTileSize;
+    const size_t lengths[] = { tile - 1, tile, tile + 1, 2 * tile - 1, 2 * tile, 2 * tile + 1, 5000 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        check_length(rng, lengths[i], tile);
+    }
+
+    // 不是 tile 整数倍的分块请求向上取整（700 -> 1024）
+    check_length(rng, 1023, 700);
+    check_length(rng, 1025, 700);
+    check_length(rng, 3000, 700);
+
+    // padlen = 3*(2*3+1) = 21：只比 padlen 多一两个样本，延拓段取自整条记录
+    check_length(rng, 22, tile);
+    check_length(rng, 23, tile);
+    check_length(rng, 43, tile);
+}
+
+static void test_too_short_removes_spill() {
+    std::mt19937 rng(120);
+    ppg::save_signal_to_file(random_smooth_signal(rng, 21), kInputPath);
+
+    bool threw = false;
+    try {
+        ppg::apply_bandpass_zerophase_file(kInputPath, kOutputPath, kSpec, 512);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "长度不大于padlen时应抛出 std::invalid_argument");
+    TEST_CHECK(!file_exists(std::string(kOutputPath) + ".spill"), "抛出异常后溢出文件仍然存在");
+}
+
+int main() {
+    test_matches_in_memory();
+    test_too_short_removes_spill();
+    std::remove(kInputPath);
+    std::remove(kOutputPath);
+    std::remove(kReferencePath);
+    return test_summary("test_streaming_filtfilt");
+}
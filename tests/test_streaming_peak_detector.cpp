@@ -0,0 +1,251 @@
+#include "streaming_peak_detector.hpp"
+#include "find_peaks.hpp"
+#include "realtime_filter.hpp"
+#include "decimator.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+// =====================================================================
+// 辅助函数
+// =====================================================================
+
+/**
+ * @brief 批量检测的峰值与谷值（谷值 = 取反信号的峰值）
+ */
+static void batch_peaks_and_valleys(
+    const std::vector<float>& signal,
+    int distance,
+    float min_height,
+    float min_prominence,
+    int wlen,
+    std::vector<int>& peaks,
+    std::vector<int>& valleys
+) {
+    peaks = find_peaks(signal, distance, min_height, min_prominence, wlen);
+    std::vector<float> inverted(signal.size());
+    for (size_t i = 0; i < signal.size(); i++) {
+        inverted[i] = -signal[i];
+    }
+    valleys = find_peaks(inverted, distance, min_height, min_prominence, wlen);
+}
+
+/**
+ * @brief 流式输出与批量结果是否一致（位置相同，值为原信号值）
+ */
+static bool same_extrema(
+    const std::vector<ppg::ConfirmedExtremum>& streamed,
+    const std::vector<int>& batch,
+    const std::vector<float>& signal
+) {
+    if (streamed.size() != batch.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (streamed[i].position != static_cast<size_t>(batch[i]) ||
+            streamed[i].value != signal[batch[i]]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 以随机块长输入整段信号并 flush，取走全部峰值与谷值
+ */
+static void run_detector(
+    ppg::StreamingPeakDetector& detector,
+    const std::vector<float>& signal,
+    std::mt19937& rng,
+    std::vector<ppg::ConfirmedExtremum>& peaks,
+    std::vector<ppg::ConfirmedExtremum>& valleys
+) {
+    std::uniform_int_distribution<int> block_size(1, 40);
+    size_t position = 0;
+    while (position < signal.size()) {
+        const size_t n = std::min(signal.size() - position, static_cast<size_t>(block_size(rng)));
+        detector.process_block(&signal[position], n);
+        position += n;
+        // 块之间取走已确认的结果，验证分批取出与一次取出相同
+        detector.take_peaks(peaks);
+        detector.take_valleys(valleys);
+    }
+    detector.flush();
+    detector.take_peaks(peaks);
+    detector.take_valleys(valleys);
+}
+
+// =====================================================================
+// 与批量 find_peaks 等价
+// =====================================================================
+
+static void test_matches_batch() {
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> length(0, 400);
+    std::uniform_int_distribution<int> levels(2, 10);
+    std::uniform_int_distribution<int> distance_dist(0, 30);
+    std::uniform_int_distribution<int> wlen_dist(0, 60);
+    std::uniform_int_distribution<int> coin(0, 3);
+    int compared_with_default_delay = 0;
+
+    for (int trial = 0; trial < 6000; trial++) {
+        const size_t n = static_cast<size_t>(length(rng));
+        const std::vector<float> signal = (trial % 2 == 0)
+            ? random_quantized_signal(rng, n, levels(rng))
+            : random_smooth_signal(rng, n);
+
+        const int distance = distance_dist(rng);
+        const float min_height = (coin(rng) == 0)
+            ? static_cast<float>(levels(rng)) * 0.2f - 0.5f
+            : -std::numeric_limits<float>::infinity();
+        const float min_prominence = (coin(rng) < 2)
+            ? -1.0f
+            : static_cast<float>(levels(rng)) * 0.25f;
+        const int wlen = (coin(rng) < 2) ? -1 : wlen_dist(rng);
+
+        std::vector<int> batch_peaks;
+        std::vector<int> batch_valleys;
+        batch_peaks_and_valleys(signal, distance, min_height, min_prominence, wlen,
+                                batch_peaks, batch_valleys);
+
+        // 延迟上限不小于信号长度时不会强制判定，结果必须与批量完全一致
+        {
+            const int max_delay = std::max(static_cast<int>(n) + 1, distance);
+            ppg::StreamingPeakDetector detector(distance, min_height, min_prominence, wlen, max_delay);
+            std::vector<ppg::ConfirmedExtremum> peaks;
+            std::vector<ppg::ConfirmedExtremum> valleys;
+            run_detector(detector, signal, rng, peaks, valleys);
+            TEST_CHECK(detector.forced_decisions() == 0,
+                       "延迟上限足够时不应强制判定 (trial " << trial << ")");
+            TEST_CHECK(same_extrema(peaks, batch_peaks, signal) &&
+                       same_extrema(valleys, batch_valleys, signal),
+                       "流式结果与批量 find_peaks 不一致 (trial " << trial << ", n=" << n
+                       << ", distance=" << distance << ", height=" << min_height
+                       << ", prominence=" << min_prominence << ", wlen=" << wlen << ")");
+        }
+
+        // 默认延迟上限：没有强制判定时同样必须一致
+        {
+            ppg::StreamingPeakDetector detector(distance, min_height, min_prominence, wlen);
+            std::vector<ppg::ConfirmedExtremum> peaks;
+            std::vector<ppg::ConfirmedExtremum> valleys;
+            run_detector(detector, signal, rng, peaks, valleys);
+            if (detector.forced_decisions() == 0) {
+                compared_with_default_delay++;
+                TEST_CHECK(same_extrema(peaks, batch_peaks, signal) &&
+                           same_extrema(valleys, batch_valleys, signal),
+                           "默认延迟上限下流式结果与批量不一致 (trial " << trial << ")");
+            }
+        }
+    }
+    TEST_CHECK(compared_with_default_delay > 3000,
+               "默认延迟上限下可比较的用例过少: " << compared_with_default_delay);
+}
+
+static void test_reset_and_confirmation_delay() {
+    std::mt19937 rng(123);
+    const std::vector<float> signal = random_smooth_signal(rng, 2000);
+    const int distance = 25;
+
+    ppg::StreamingPeakDetector detector(distance);
+    std::vector<ppg::ConfirmedExtremum> peaks;
+    std::vector<ppg::ConfirmedExtremum> valleys;
+    size_t longest_delay = 0;
+    for (size_t i = 0; i < signal.size(); i++) {
+        detector.process_sample(signal[i]);
+        const size_t before = peaks.size();
+        detector.take_peaks(peaks);
+        for (size_t k = before; k < peaks.size(); k++) {
+            longest_delay = std::max(longest_delay, i - peaks[k].position);
+        }
+        detector.take_valleys(valleys);
+    }
+    TEST_CHECK(longest_delay <= static_cast<size_t>(detector.max_delay()),
+               "确认延迟 " << longest_delay << " 超过上限 " << detector.max_delay());
+
+    // reset 后重新输入同一信号，结果与第一次相同
+    detector.flush();
+    detector.take_peaks(peaks);
+    detector.take_valleys(valleys);
+    detector.reset();
+    std::vector<ppg::ConfirmedExtremum> peaks_again;
+    std::vector<ppg::ConfirmedExtremum> valleys_again;
+    run_detector(detector, signal, rng, peaks_again, valleys_again);
+    TEST_CHECK(peaks_again.size() == peaks.size() && valleys_again.size() == valleys.size(),
+               "reset 后的结果与第一次不同");
+}
+
+// =====================================================================
+// realtime_main 的配置下不发生强制判定
+// =====================================================================
+
+/**
+ * @brief 合成 1000 Hz 的 int16 PPG：心率在 45 ~ 145 bpm 间缓慢变化，
+ *        含重搏波、呼吸基线漂移与噪声
+ */
+static std::vector<float> synthetic_ppg(std::mt19937& rng, double sample_rate, double seconds) {
+    std::uniform_real_distribution<double> noise(-8.0, 8.0);
+    const size_t n = static_cast<size_t>(sample_rate * seconds);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / sample_rate;
+        const double heart_rate = 95.0 + 50.0 * std::sin(2.0 * M_PI * t / 97.0);
+        phase = std::fmod(phase + heart_rate / 60.0 / sample_rate, 1.0);
+        const double systolic = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        const double dicrotic = std::exp(-std::pow((phase - 0.55) / 0.1, 2.0));
+        const double baseline = 60.0 * std::sin(2.0 * M_PI * 0.25 * t);
+        signal[i] = static_cast<float>(std::round(
+            2000.0 + baseline + 300.0 * systolic + 90.0 * dicrotic + noise(rng)));
+    }
+    return signal;
+}
+
+static void test_no_forced_decisions_in_realtime_settings() {
+    // 与 realtime_main 相同：1000 Hz 带通 0.5-20 Hz 三阶，抽取到 100 Hz，
+    // 最小峰值间隔 0.4 秒（distance = 40），默认最大确认延迟
+    const double sample_rate = 1000.0;
+    const double analysis_rate = 100.0;
+    const int peak_distance = static_cast<int>(analysis_rate * 0.4);
+
+    std::mt19937 rng(2023);
+    const std::vector<float> raw = synthetic_ppg(rng, sample_rate, 600.0);
+
+    ppg::RealtimeFilter filter(ppg::BandPassSpec(0.5, 20.0, sample_rate, 3));
+    ppg::Decimator decimator(sample_rate, analysis_rate, 20.0);
+    filter.prime(raw[0]);
+
+    std::vector<float> analysis;
+    for (size_t i = 0; i < raw.size(); i++) {
+        float decimated = 0.0f;
+        if (decimator.process_sample(filter.process_sample(raw[i]), decimated)) {
+            // realtime_main 把滤波结果取整存入 int16 缓冲区，检测器输入相同的整数值
+            analysis.push_back(std::round(decimated));
+        }
+    }
+
+    ppg::StreamingPeakDetector detector(peak_distance);
+    std::vector<ppg::ConfirmedExtremum> peaks;
+    std::vector<ppg::ConfirmedExtremum> valleys;
+    run_detector(detector, analysis, rng, peaks, valleys);
+    TEST_CHECK(detector.forced_decisions() == 0,
+               "realtime_main 配置下发生了 " << detector.forced_decisions() << " 次强制判定");
+
+    std::vector<int> batch_peaks;
+    std::vector<int> batch_valleys;
+    batch_peaks_and_valleys(analysis, peak_distance, -std::numeric_limits<float>::infinity(),
+                            -1.0f, -1, batch_peaks, batch_valleys);
+    TEST_CHECK(same_extrema(peaks, batch_peaks, analysis) &&
+               same_extrema(valleys, batch_valleys, analysis),
+               "realtime_main 配置下流式结果与批量不一致");
+    // 600 秒、45 ~ 145 bpm，心搏数应在合理范围内（确认检测本身在工作）
+    TEST_CHECK(peaks.size() > 450 && peaks.size() < 1450,
+               "检出的峰值数不合理: " << peaks.size());
+}
+
+int main() {
+    test_matches_batch();
+    test_reset_and_confirmation_delay();
+    test_no_forced_decisions_in_realtime_settings();
+    return test_summary("test_streaming_peak_detector");
+}
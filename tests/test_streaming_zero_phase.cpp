@@ -0,0 +1,125 @@
+#include "realtime_filter.hpp"
+#include "ppg_filters.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// =====================================================================
+// StreamingZeroPhaseFilter 相对离线 filtfilt 的误差上限与参数检查
+// =====================================================================
+
+namespace {
+
+const double kSampleRate = 1000.0;
+const double kLowFreq = 0.5;
+const double kHighFreq = 20.0;
+const int kFilterOrder = 3;
+
+/**
+ * @brief 合成 1000 Hz PPG：心率缓慢变化，含重搏波、呼吸基线漂移与噪声
+ */
+std::vector<float> synthetic_ppg(std::mt19937& rng, double seconds) {
+    std::normal_distribution<double> noise(0.0, 20.0);
+    const size_t n = static_cast<size_t>(kSampleRate * seconds);
+    std::vector<float> signal(n);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        const double heart_rate = 1.2 + 0.2 * std::sin(2.0 * M_PI * t / 7.0);
+        phase = std::fmod(phase + heart_rate / kSampleRate, 1.0);
+        const double systolic = std::exp(-std::pow((phase - 0.2) / 0.08, 2.0));
+        const double dicrotic = std::exp(-std::pow((phase - 0.55) / 0.1, 2.0));
+        const double baseline = 300.0 * std::sin(2.0 * M_PI * 0.25 * t);
+        signal[i] = static_cast<float>(30000.0 + 2000.0 * systolic + 600.0 * dicrotic +
+                                       baseline + noise(rng));
+    }
+    return signal;
+}
+
+/**
+ * @brief 流式输出（按延迟对齐后）相对离线结果的均方根误差 / 离线结果均方根
+ *
+ * 只比较中间段：开头受正向滤波启动影响，结尾受离线filtfilt边界延拓影响。
+ */
+double relative_rms_error(const std::vector<float>& input, ppg::StreamingZeroPhaseFilter& filter) {
+    std::vector<float> streamed(input.size());
+    filter.process_block(input.data(), streamed.data(), input.size());
+
+    const std::vector<float> reference = ppg::apply_bandpass_zerophase(
+        input, kLowFreq, kHighFreq, kSampleRate, kFilterOrder);
+
+    const size_t latency = filter.latency_samples();
+    const size_t begin = static_cast<size_t>(8.0 * kSampleRate);
+    const size_t end = input.size() - latency - static_cast<size_t>(8.0 * kSampleRate);
+    double error_sq = 0.0;
+    double reference_sq = 0.0;
+    for (size_t i = begin; i < end; i++) {
+        const double error = streamed[i + latency] - reference[i];
+        error_sq += error * error;
+        reference_sq += static_cast<double>(reference[i]) * reference[i];
+    }
+    return reference_sq > 0.0 ? std::sqrt(error_sq / reference_sq) : 0.0;
+}
+
+double relative_rms_error(const std::vector<float>& input, double lookahead_seconds) {
+    ppg::StreamingZeroPhaseFilter filter(kLowFreq, kHighFreq, kSampleRate, kFilterOrder,
+                                         lookahead_seconds);
+    return relative_rms_error(input, filter);
+}
+
+} // namespace
+
+static void test_default_lookahead_bound() {
+    std::mt19937 rng(7);
+    const std::vector<float> input = synthetic_ppg(rng, 40.0);
+
+    // 默认前瞻（500 ms）：延迟为前瞻加块长（前瞻的1/4）减1，误差为类说明中保证的上限
+    ppg::StreamingZeroPhaseFilter filter(kLowFreq, kHighFreq, kSampleRate, kFilterOrder);
+    const size_t lookahead = static_cast<size_t>(0.5 * kSampleRate);
+    TEST_CHECK(filter.latency_samples() == lookahead + lookahead / 4 - 1,
+               "默认前瞻应为500ms，实际延迟 " << filter.latency_seconds() << " 秒");
+
+    const double error = relative_rms_error(input, filter);
+    TEST_CHECK(error <= 0.12, "默认前瞻下相对离线filtfilt的误差 " << 100.0 * error
+               << "% 超过 12%");
+    std::cout << "  默认前瞻: 延迟 " << filter.latency_seconds() << " 秒, 均方根误差 "
+              << 100.0 * error << "%" << std::endl;
+}
+
+static void test_long_lookahead_bound() {
+    std::mt19937 rng(7);
+    const std::vector<float> input = synthetic_ppg(rng, 40.0);
+
+    // 显式选用2秒前瞻：类说明中保证的上限
+    const double error_2s = relative_rms_error(input, 2.0);
+    TEST_CHECK(error_2s <= 0.02, "2秒前瞻下相对离线filtfilt的误差 " << 100.0 * error_2s
+               << "% 超过 2%");
+
+    // 误差随前瞻缩短而增大，且与类说明中的量级一致
+    const double error_1s = relative_rms_error(input, 1.0);
+    const double error_500ms = relative_rms_error(input, 0.5);
+    TEST_CHECK(error_1s <= 0.08, "1秒前瞻误差 " << 100.0 * error_1s << "% 超过 8%");
+    TEST_CHECK(error_2s <= error_1s && error_1s <= error_500ms, "误差应随前瞻增长而减小");
+
+    std::cout << "  相对离线filtfilt的均方根误差: 500ms " << 100.0 * error_500ms
+              << "%, 1s " << 100.0 * error_1s << "%, 2s " << 100.0 * error_2s << "%" << std::endl;
+}
+
+static void test_stage_count_checked() {
+    bool threw = false;
+    try {
+        // 7阶带通需要7节，超过6节的设计上限
+        ppg::StreamingZeroPhaseFilter filter(kLowFreq, kHighFreq, kSampleRate, 7);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_CHECK(threw, "节数超出范围时应抛出 std::invalid_argument");
+}
+
+int main() {
+    test_default_lookahead_bound();
+    test_long_lookahead_bound();
+    test_stage_count_checked();
+    return test_summary("test_streaming_zero_phase");
+}
@@ -0,0 +1,71 @@
+#ifndef TEST_UTILS_HPP
+#define TEST_UTILS_HPP
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cmath>
+
+// =====================================================================
+// 测试公用工具：断言计数与随机信号
+// =====================================================================
+
+/**
+ * @brief 失败计数（每个测试程序一份）
+ */
+static int g_test_failures = 0;
+
+/**
+ * @brief 断言：失败时打印位置与说明并计数，不中止（便于一次看到所有失败）
+ */
+#define TEST_CHECK(condition, message)                                      \
+    do {                                                                    \
+        if (!(condition)) {                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 失败: "          \
+                      << message << std::endl;                              \
+            g_test_failures++;                                              \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief 汇总结果，作为 main 的返回值（0 表示全部通过）
+ */
+inline int test_summary(const char* name) {
+    if (g_test_failures == 0) {
+        std::cout << name << ": 全部通过" << std::endl;
+        return 0;
+    }
+    std::cout << name << ": " << g_test_failures << " 项失败" << std::endl;
+    return 1;
+}
+
+/**
+ * @brief 量化随机信号：取值为 0 ~ levels-1 的整数
+ *
+ * 取值少时大量出现等高峰值与平台，用于覆盖并列和平台的边界规则。
+ */
+inline std::vector<float> random_quantized_signal(std::mt19937& rng, size_t n, int levels) {
+    std::uniform_int_distribution<int> value(0, levels - 1);
+    std::vector<float> signal(n);
+    for (size_t i = 0; i < n; i++) {
+        signal[i] = static_cast<float>(value(rng));
+    }
+    return signal;
+}
+
+/**
+ * @brief 连续随机信号：正弦加噪声（近似PPG的准周期波形）
+ */
+inline std::vector<float> random_smooth_signal(std::mt19937& rng, size_t n) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float period = 20.0f + 80.0f * unit(rng);
+    const float noise = 0.5f * unit(rng);
+    std::vector<float> signal(n);
+    for (size_t i = 0; i < n; i++) {
+        signal[i] = std::sin(6.2831853f * static_cast<float>(i) / period) +
+                    noise * (unit(rng) - 0.5f);
+    }
+    return signal;
+}
+
+#endif // TEST_UTILS_HPP